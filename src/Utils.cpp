@@ -50,4 +50,96 @@ std::size_t utils::levenshtein(std::string s1, std::string s2, bool case_sensiti
 	}
 
 	return costs[n];
-}
\ No newline at end of file
+}
+utils::mapped_file::mapped_file(const std::filesystem::path& path)
+{
+#ifdef _WIN32
+	_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (_file == INVALID_HANDLE_VALUE)
+		throw std::runtime_error{ "couldn't open file" };
+
+	LARGE_INTEGER size{};
+	GetFileSizeEx(_file, &size);
+	_size = static_cast<std::size_t>(size.QuadPart);
+	if (_size == 0u)
+		return;
+
+	_mapping = CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (_mapping != nullptr)
+		_data = static_cast<const unsigned char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+	_fd = open(path.c_str(), O_RDONLY);
+	if (_fd == -1)
+		throw std::runtime_error{ "couldn't open file" };
+
+	struct stat st {};
+	fstat(_fd, &st);
+	_size = static_cast<std::size_t>(st.st_size);
+	if (_size == 0u)
+		return;
+
+	void* address = mmap(nullptr, _size, PROT_READ, MAP_SHARED, _fd, 0);
+	if (address != MAP_FAILED)
+		_data = static_cast<const unsigned char*>(address);
+#endif
+
+	if (_data == nullptr)
+	{
+		close();
+		throw std::runtime_error{ "couldn't map file" };
+	}
+}
+
+utils::mapped_file::~mapped_file()
+{
+	close();
+}
+
+utils::mapped_file::mapped_file(mapped_file&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+utils::mapped_file& utils::mapped_file::operator=(mapped_file&& other) noexcept
+{
+	if (this != &other)
+	{
+		close();
+
+#ifdef _WIN32
+		_file = std::exchange(other._file, INVALID_HANDLE_VALUE);
+		_mapping = std::exchange(other._mapping, nullptr);
+#else
+		_fd = std::exchange(other._fd, -1);
+#endif
+		_data = std::exchange(other._data, nullptr);
+		_size = std::exchange(other._size, 0u);
+	}
+
+	return *this;
+}
+
+void utils::mapped_file::close() noexcept
+{
+#ifdef _WIN32
+	if (_data != nullptr)
+		UnmapViewOfFile(_data);
+	if (_mapping != nullptr)
+		CloseHandle(_mapping);
+	if (_file != INVALID_HANDLE_VALUE)
+		CloseHandle(_file);
+
+	_file = INVALID_HANDLE_VALUE;
+	_mapping = nullptr;
+#else
+	if (_data != nullptr)
+		munmap(const_cast<unsigned char*>(_data), _size);
+	if (_fd != -1)
+		::close(_fd);
+
+	_fd = -1;
+#endif
+
+	_data = nullptr;
+	_size = 0u;
+}
@@ -78,6 +78,35 @@ namespace utils
 	}
 
 	std::size_t levenshtein(std::string s1, std::string s2, bool case_sensitive = false);
+
+	// Read-only memory mapping of a whole file, the pages are loaded by the OS on first access
+	class mapped_file
+	{
+#ifdef _WIN32
+		HANDLE _file{ INVALID_HANDLE_VALUE };
+		HANDLE _mapping{ nullptr };
+#else
+		int _fd{ -1 };
+#endif
+		const unsigned char* _data{ nullptr };
+		std::size_t _size{ 0u };
+
+		void close() noexcept;
+
+	public:
+		mapped_file() = default;
+		explicit mapped_file(const std::filesystem::path& path);
+		~mapped_file();
+
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+		mapped_file(mapped_file&& other) noexcept;
+		mapped_file& operator=(mapped_file&& other) noexcept;
+
+		inline const unsigned char* data() const noexcept { return _data; }
+		inline std::size_t size() const noexcept { return _size; }
+		inline bool empty() const noexcept { return _size == 0u; }
+	};
 }
 
 constexpr std::uint32_t operator""_hash(const char* s, size_t c)
@@ -30,6 +30,7 @@ namespace net
 		_Send_fun = vmt[7];
 		_RPC_fun = vmt[32];
 		_GetPlayerIdFromIndex_fun = vmt[58];
+		_GetIndexFromPlayerId_fun = vmt[57];
 		_DeallocatePacket_fun = vmt[12];
 		_Receive_fun = vmt[10];
 
@@ -38,11 +39,22 @@ namespace net
 			vmt[10] = reinterpret_cast<urmem::address_t>(&RakServer__Receive);
 		}
 
+		{
+			urmem::unprotect_scope lk(reinterpret_cast<urmem::address_t>(&vmt[7]), sizeof(urmem::address_t));
+			vmt[7] = reinterpret_cast<urmem::address_t>(&RakServer__Send);
+		}
+
+		{
+			urmem::unprotect_scope lk(reinterpret_cast<urmem::address_t>(&vmt[32]), sizeof(urmem::address_t));
+			vmt[32] = reinterpret_cast<urmem::address_t>(&RakServer__RPC);
+		}
+
 		if (!scanner.find("\x8B\x44\x24\x04\x85\xC0\x75\x03\x0C\xFF\xC3\x8B\x48\x10\x8A\x01\x3C\xFF\x75\x03\x8A\x41\x05\xC3", "?????xxxxxxxxxxxx?xxxxxx", _GetPacketId_fun) || !_GetPacketId_fun)
 #else
 		_Send_fun = vmt[9];
 		_RPC_fun = vmt[35];
 		_GetPlayerIdFromIndex_fun = vmt[59];
+		_GetIndexFromPlayerId_fun = vmt[58];
 		_DeallocatePacket_fun = vmt[13];
 		_Receive_fun = vmt[11];
 
@@ -51,6 +63,16 @@ namespace net
 			vmt[11] = reinterpret_cast<urmem::address_t>(&RakServer__Receive);
 		}
 
+		{
+			urmem::unprotect_scope lk(reinterpret_cast<urmem::address_t>(&vmt[9]), sizeof(urmem::address_t));
+			vmt[9] = reinterpret_cast<urmem::address_t>(&RakServer__Send);
+		}
+
+		{
+			urmem::unprotect_scope lk(reinterpret_cast<urmem::address_t>(&vmt[35]), sizeof(urmem::address_t));
+			vmt[35] = reinterpret_cast<urmem::address_t>(&RakServer__RPC);
+		}
+
 		if (!scanner.find("\x55\xB8\xFF\x00\x00\x00\x89\xE5\x8B\x55\x08\x85\xD2\x74\x0D\x8B\x52\x10\x0F\xB6\x02\x3C\xFF\x74\x07\x0F\xB6\xC0\x5D\xC3\x66\x90\x0F\xB6\x42\x05\x5D\xC3", "?????xxxxxxxxxxxxxxxxx?xxxxxxxxxxxxxxx", _GetPacketId_fun) || !_GetPacketId_fun)
 #endif
 		{
@@ -69,8 +91,18 @@ namespace net
 		return urmem::call_function<urmem::calling_convention::thiscall, PlayerID>(_GetPlayerIdFromIndex_fun, _rakserver, index);
 	}
 
+	int CRakServer::GetIndexFromPlayerID(PlayerID playerid) const
+	{
+		return urmem::call_function<urmem::calling_convention::thiscall, int>(_GetIndexFromPlayerId_fun, _rakserver, playerid);
+	}
+
 	bool CRakServer::SendPacket(BitStream* bs, int index, PacketPriority priority, PacketReliability reliability) const
 	{
+		if (bs->GetNumberOfBytesUsed() > 0)
+		{
+			stats::traffic.Count(stats::packet, stats::outgoing, bs->GetData()[0], static_cast<std::uint16_t>(index), bs->GetNumberOfBytesUsed());
+		}
+
 		if (index == -1)
 		{
 			return urmem::call_function<urmem::calling_convention::thiscall, bool>(_Send_fun, _rakserver, bs, priority, reliability, 0, UNASSIGNED_PLAYER_ID, true);
@@ -80,16 +112,24 @@ namespace net
 
 	bool CRakServer::SendPacket(BitStream* bs, PlayerID playerid, PacketPriority priority, PacketReliability reliability) const
 	{
+		if (bs->GetNumberOfBytesUsed() > 0)
+		{
+			stats::traffic.Count(stats::packet, stats::outgoing, bs->GetData()[0], 0xFFFF, bs->GetNumberOfBytesUsed());
+		}
+
 		return urmem::call_function<urmem::calling_convention::thiscall, bool>(_Send_fun, _rakserver, bs, priority, reliability, 0, playerid, (playerid == UNASSIGNED_PLAYER_ID));
 	}
 
 	bool CRakServer::SendRPC(BitStream* bs, unsigned char rpcid, int index, PacketPriority priority, PacketReliability reliability, unsigned ordering_channel, bool broadcast)
 	{
+		stats::traffic.Count(stats::rpc, stats::outgoing, rpcid, (broadcast ? 0xFFFF : static_cast<std::uint16_t>(index)), bs->GetNumberOfBytesUsed());
 		return urmem::call_function<urmem::calling_convention::thiscall, bool>(_RPC_fun, _rakserver, &rpcid, bs, priority, reliability, ordering_channel, GetPlayerIDFromIndex(index), broadcast, false);
 	}
 
 	bool CRakServer::SendRPC(BitStream* bs, unsigned char rpcid, PlayerID playerid, PacketPriority priority, PacketReliability reliability, unsigned ordering_channel, bool broadcast)
 	{
+		// The player slot isn't known here, only the ID totals are accounted
+		stats::traffic.Count(stats::rpc, stats::outgoing, rpcid, 0xFFFF, bs->GetNumberOfBytesUsed());
 		return urmem::call_function<urmem::calling_convention::thiscall, bool>(_RPC_fun, _rakserver, &rpcid, bs, priority, reliability, ordering_channel, playerid, broadcast, false);
 	}
 
@@ -103,16 +143,9 @@ namespace net
 		return urmem::call_function<urmem::calling_convention::thiscall, Packet*>(_Receive_fun, _rakserver);
 	}
 
-	Packet* FASTCALL RakServer__Receive(void* _this)
+	bool ProcessPacket(std::uint16_t playerid, std::uint8_t packetid, BitStream* bs)
 	{
-		Packet* packet = RakServer->Receive();
-		auto packetid = CRakServer::GetPacketId(packet);
-		if (packetid == 0xFF)
-			return packet;
-
-		auto playerid = packet->playerIndex;
-		if (playerid == static_cast<PlayerIndex>(-1))
-			return packet;
+		const auto length = bs->GetNumberOfBytesUsed();
 
 		if (server::player_pool.Exists(playerid))
 		{
@@ -122,8 +155,8 @@ namespace net
 			{
 				case net::raknet::ID_PLAYER_SYNC:
 				{
-					if (packet->length >= sizeof(stOnFootSyncData) + 1)
-						return nullptr;
+					if (length >= sizeof(stOnFootSyncData) + 1)
+						return false;
 
 					if (player->Paused())
 					{
@@ -132,18 +165,19 @@ namespace net
 
 					player->LastUpdateTick() = std::chrono::steady_clock::now();
 
-					stOnFootSyncData* data = reinterpret_cast<stOnFootSyncData*>(&packet->data[1]);
+					stOnFootSyncData* data = reinterpret_cast<stOnFootSyncData*>(&bs->GetData()[1]);
 					player->Position().x = data->vecPos.X;
 					player->Position().y = data->vecPos.Y;
 					player->Position().z = data->vecPos.Z;
-					GetPlayerFacingAngle(packet->playerIndex, &player->Position().w);
+					GetPlayerFacingAngle(playerid, &player->Position().w);
+					server::spatial::player_grid.Update(playerid, { data->vecPos.X, data->vecPos.Y, data->vecPos.Z });
 
 					break;
 				}
 				case net::raknet::ID_VEHICLE_SYNC:
 				{
-					if (packet->length >= sizeof(stVehicleSyncData) + 1)
-						return nullptr;
+					if (length >= sizeof(stVehicleSyncData) + 1)
+						return false;
 
 					if (player->Paused())
 					{
@@ -151,12 +185,18 @@ namespace net
 					}
 
 					player->LastUpdateTick() = std::chrono::steady_clock::now();
+
+					stVehicleSyncData* data = reinterpret_cast<stVehicleSyncData*>(&bs->GetData()[1]);
+					player->Position().x = data->vecPos[0];
+					player->Position().y = data->vecPos[1];
+					player->Position().z = data->vecPos[2];
+					server::spatial::player_grid.Update(playerid, { data->vecPos[0], data->vecPos[1], data->vecPos[2] });
 					break;
 				}
 				case net::raknet::ID_PASSENGER_SYNC:
 				{
-					if (packet->length >= sizeof(stPassengerSyncData) + 1)
-						return nullptr;
+					if (length >= sizeof(stPassengerSyncData) + 1)
+						return false;
 
 					if (player->Paused())
 					{
@@ -164,12 +204,18 @@ namespace net
 					}
 
 					player->LastUpdateTick() = std::chrono::steady_clock::now();
+
+					stPassengerSyncData* data = reinterpret_cast<stPassengerSyncData*>(&bs->GetData()[1]);
+					player->Position().x = data->VecPos[0];
+					player->Position().y = data->VecPos[1];
+					player->Position().z = data->VecPos[2];
+					server::spatial::player_grid.Update(playerid, { data->VecPos[0], data->VecPos[1], data->VecPos[2] });
 					break;
 				}
 				case net::raknet::ID_SPECTATOR_SYNC:
 				{
-					if (packet->length >= sizeof(stSpectatingSyncData) + 1)
-						return nullptr;
+					if (length >= sizeof(stSpectatingSyncData) + 1)
+						return false;
 
 					if (player->Paused())
 					{
@@ -181,8 +227,8 @@ namespace net
 				}
 				case net::raknet::ID_AIM_SYNC:
 				{
-					if (packet->length >= sizeof(stAimSyncData) + 1)
-						return nullptr;
+					if (length >= sizeof(stAimSyncData) + 1)
+						return false;
 
 					if (player->Paused())
 					{
@@ -194,8 +240,8 @@ namespace net
 				}
 				case net::raknet::ID_TRAILER_SYNC:
 				{
-					if (packet->length >= sizeof(stTrailerSyncData) + 1)
-						return nullptr;
+					if (length >= sizeof(stTrailerSyncData) + 1)
+						return false;
 
 					if (player->Paused())
 					{
@@ -208,18 +254,80 @@ namespace net
 			}
 		}
 
-		BitStream bs{ &packet->data[0], packet->length, false };
-
 		auto rg = _packet_receivers.equal_range(packetid);
 		for (auto it = rg.first; it != rg.second; ++it)
 		{
-			if (!it->second->call(playerid, &bs))
-			{
-				RakServer->DeallocatePacket(packet);
-				return packet;
-			}
+			if (!it->second->call(playerid, bs))
+				return false;
 
-			bs.ResetReadPointer();
+			bs->ResetReadPointer();
+		}
+
+		return true;
+	}
+
+	// Broadcasts aren't split per player, like the ones the gamemode sends
+	static std::uint16_t OutgoingSlot(PlayerID playerid, bool broadcast)
+	{
+		if (broadcast)
+			return 0xFFFF;
+
+		const auto index = RakServer->GetIndexFromPlayerID(playerid);
+		return (index >= 0 && index < MAX_PLAYERS ? static_cast<std::uint16_t>(index) : 0xFFFF);
+	}
+
+#ifdef _WIN32
+	bool __fastcall CRakServer::RakServer__Send(void* _this, void* /*_edx*/, BitStream* bs, PacketPriority priority, PacketReliability reliability, char ordering_channel, PlayerID playerid, bool broadcast)
+#else
+	bool CRakServer::RakServer__Send(void* _this, BitStream* bs, PacketPriority priority, PacketReliability reliability, char ordering_channel, PlayerID playerid, bool broadcast)
+#endif
+	{
+		if (bs && bs->GetNumberOfBytesUsed() > 0)
+		{
+			stats::traffic.Count(stats::packet, stats::outgoing, bs->GetData()[0], OutgoingSlot(playerid, broadcast), bs->GetNumberOfBytesUsed());
+		}
+
+		return urmem::call_function<urmem::calling_convention::thiscall, bool>(RakServer->_Send_fun, _this, bs, priority, reliability, ordering_channel, playerid, broadcast);
+	}
+
+#ifdef _WIN32
+	bool __fastcall CRakServer::RakServer__RPC(void* _this, void* /*_edx*/, unsigned char* rpcid, BitStream* bs, PacketPriority priority, PacketReliability reliability, char ordering_channel, PlayerID playerid, bool broadcast, bool shift_timestamp)
+#else
+	bool CRakServer::RakServer__RPC(void* _this, unsigned char* rpcid, BitStream* bs, PacketPriority priority, PacketReliability reliability, char ordering_channel, PlayerID playerid, bool broadcast, bool shift_timestamp)
+#endif
+	{
+		if (rpcid)
+		{
+			stats::traffic.Count(stats::rpc, stats::outgoing, *rpcid, OutgoingSlot(playerid, broadcast), (bs ? bs->GetNumberOfBytesUsed() : 0));
+		}
+
+		return urmem::call_function<urmem::calling_convention::thiscall, bool>(RakServer->_RPC_fun, _this, rpcid, bs, priority, reliability, ordering_channel, playerid, broadcast, shift_timestamp);
+	}
+
+	Packet* FASTCALL RakServer__Receive(void* _this)
+	{
+		Packet* packet = RakServer->Receive();
+		auto packetid = CRakServer::GetPacketId(packet);
+		if (packetid == 0xFF)
+			return packet;
+
+		auto playerid = packet->playerIndex;
+		if (playerid == static_cast<PlayerIndex>(-1))
+			return packet;
+
+		stats::traffic.Count(stats::packet, stats::incoming, packetid, playerid, packet->length);
+
+		if (capture::recorder.Recording())
+		{
+			capture::recorder.Record(playerid, packetid, packet->data, packet->length);
+		}
+
+		BitStream bs{ &packet->data[0], packet->length, false };
+
+		if (!ProcessPacket(playerid, packetid, &bs))
+		{
+			RakServer->DeallocatePacket(packet);
+			return nullptr;
 		}
 
 		if (packet->data != bs.GetData())
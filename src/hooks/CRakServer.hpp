@@ -15,15 +15,26 @@ namespace net
 		urmem::address_t _Send_fun;
 		urmem::address_t _RPC_fun;
 		urmem::address_t _GetPlayerIdFromIndex_fun;
+		urmem::address_t _GetIndexFromPlayerId_fun;
 		urmem::address_t _DeallocatePacket_fun;
 		urmem::address_t _Receive_fun;
 		inline static urmem::address_t _GetPacketId_fun;
 
+		// The server core sends through the virtual table, these count that traffic and call the original
+#ifdef _WIN32
+		static bool __fastcall RakServer__Send(void* _this, void* _edx, BitStream* bs, PacketPriority priority, PacketReliability reliability, char ordering_channel, PlayerID playerid, bool broadcast);
+		static bool __fastcall RakServer__RPC(void* _this, void* _edx, unsigned char* rpcid, BitStream* bs, PacketPriority priority, PacketReliability reliability, char ordering_channel, PlayerID playerid, bool broadcast, bool shift_timestamp);
+#else
+		static bool RakServer__Send(void* _this, BitStream* bs, PacketPriority priority, PacketReliability reliability, char ordering_channel, PlayerID playerid, bool broadcast);
+		static bool RakServer__RPC(void* _this, unsigned char* rpcid, BitStream* bs, PacketPriority priority, PacketReliability reliability, char ordering_channel, PlayerID playerid, bool broadcast, bool shift_timestamp);
+#endif
+
 	public:
 		CRakServer(void** plugin_data);
 		~CRakServer() = default;
 
 		PlayerID GetPlayerIDFromIndex(int index) const;
+		int GetIndexFromPlayerID(PlayerID playerid) const;
 		static std::uint8_t GetPacketId(Packet* packet);
 
 		bool SendPacket(BitStream* bs, int index = -1, PacketPriority priority = LOW_PRIORITY, PacketReliability reliability = RELIABLE) const;
@@ -36,5 +47,7 @@ namespace net
 
 	extern std::unique_ptr<CRakServer> RakServer;
 
+	// Runs the sync bookkeeping and the registered receivers for an incoming packet. Returns false if the packet must be dropped.
+	bool ProcessPacket(std::uint16_t playerid, std::uint8_t packetid, BitStream* bs);
 	Packet* FASTCALL RakServer__Receive(void* _this);
 };
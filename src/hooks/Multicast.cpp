@@ -0,0 +1,34 @@
+#include "../main.hpp"
+
+net::Multicast& net::Multicast::Patch(std::size_t offset, std::uint8_t size, resolver resolve)
+{
+	assert(size <= sizeof(std::uint32_t) && offset + size <= static_cast<std::size_t>(_bs->GetNumberOfBytesUsed()));
+
+	_patches.push_back({ offset, size, std::move(resolve) });
+	return *this;
+}
+
+void net::Multicast::Send(const recipients& to)
+{
+	if (to.none())
+		return;
+
+	auto* data = _bs->GetData();
+
+	for (std::uint16_t playerid = 0; playerid < to.size(); ++playerid)
+	{
+		if (!to.test(playerid))
+			continue;
+
+		for (auto&& patch : _patches)
+		{
+			const std::uint32_t value = patch.resolve(playerid);
+			std::memcpy(data + patch.offset, &value, patch.size);
+		}
+
+		if (_type)
+			rpc_queue.Push(_bs, _rpcid, playerid, *_type);
+		else
+			rpc_queue.Push(_bs, _rpcid, playerid, _priority, _reliability, _ordering_channel);
+	}
+}
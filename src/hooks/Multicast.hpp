@@ -0,0 +1,45 @@
+#pragma once
+
+namespace net
+{
+	// Sends one serialized RPC to a set of players. The payload is written once and only the patched
+	// bytes (per-player textdraw IDs, colors...) are rewritten before queueing it for each recipient.
+	class Multicast
+	{
+	public:
+		using recipients = std::bitset<MAX_PLAYERS>;
+		using resolver = std::function<std::uint32_t(std::uint16_t playerid)>;
+
+	private:
+		struct patch_slot
+		{
+			std::size_t offset; // In bytes
+			std::uint8_t size;
+			resolver resolve;
+		};
+
+		BitStream* _bs;
+		unsigned char _rpcid;
+		PacketPriority _priority;
+		PacketReliability _reliability;
+		unsigned _ordering_channel;
+		// Resolved for each player once the payload is patched, textdraw IDs decide the channel
+		std::optional<message_class> _type;
+		std::vector<patch_slot> _patches;
+
+	public:
+		Multicast(BitStream* bs, unsigned char rpcid, PacketPriority priority = HIGH_PRIORITY, PacketReliability reliability = RELIABLE, unsigned ordering_channel = 0)
+			: _bs(bs), _rpcid(rpcid), _priority(priority), _reliability(reliability), _ordering_channel(ordering_channel)
+		{}
+
+		Multicast(BitStream* bs, unsigned char rpcid, message_class type)
+			: Multicast(bs, rpcid)
+		{
+			_type = type;
+		}
+
+		// The bytes at `offset` must already be part of the payload, write a placeholder for them.
+		Multicast& Patch(std::size_t offset, std::uint8_t size, resolver resolve);
+		void Send(const recipients& to);
+	};
+}
@@ -0,0 +1,155 @@
+#include "../main.hpp"
+
+net::stats::CTrafficStats net::stats::traffic{};
+
+void net::stats::CTrafficStats::Sample()
+{
+	auto& snap = _snapshots[_head];
+
+	for (std::size_t type = 0; type < 2; ++type)
+	{
+		for (std::size_t dir = 0; dir < 2; ++dir)
+		{
+			for (std::size_t id = 0; id < 256; ++id)
+			{
+				snap.ids[type][dir][id] = _ids[type][dir][id].load();
+			}
+		}
+	}
+
+	for (std::size_t playerid = 0; playerid < MAX_PLAYERS; ++playerid)
+	{
+		snap.players[playerid][incoming] = _players[playerid][incoming].load();
+		snap.players[playerid][outgoing] = _players[playerid][outgoing].load();
+	}
+
+	_head = (_head + 1) % _snapshots.size();
+	_filled = std::min(_filled + 1, _snapshots.size());
+}
+
+net::stats::report net::stats::CTrafficStats::Report() const
+{
+	report data;
+	if (_filled < 2)
+		return data;
+
+	const auto count = _snapshots.size();
+	const auto& newest = _snapshots[(_head + count - 1) % count];
+	const auto& oldest = _snapshots[(_filled < count ? 0 : _head)];
+	data.window = std::chrono::seconds{ _filled - 1 };
+
+	// Unsigned subtraction keeps the deltas right even if a counter wrapped around inside the window
+	auto delta = [](const sample& now, const sample& then) -> sample {
+		return { now.messages - then.messages, now.bytes - then.bytes };
+	};
+
+	for (std::uint8_t dir = 0; dir < 2; ++dir)
+	{
+		for (std::uint8_t type = 0; type < 2; ++type)
+		{
+			for (std::size_t id = 0; id < 256; ++id)
+			{
+				auto traffic = delta(newest.ids[type][dir][id], oldest.ids[type][dir][id]);
+				if (!traffic.messages)
+					continue;
+
+				data.totals[dir].messages += traffic.messages;
+				data.totals[dir].bytes += traffic.bytes;
+				data.ids[dir].push_back({ static_cast<kind>(type), static_cast<std::uint8_t>(id), traffic });
+			}
+		}
+
+		for (std::uint16_t playerid = 0; playerid < MAX_PLAYERS; ++playerid)
+		{
+			auto traffic = delta(newest.players[playerid][dir], oldest.players[playerid][dir]);
+			if (traffic.messages)
+				data.players[dir].push_back({ playerid, traffic });
+		}
+
+		std::sort(data.ids[dir].begin(), data.ids[dir].end(), [](const auto& a, const auto& b) { return a.traffic.bytes > b.traffic.bytes; });
+		std::sort(data.players[dir].begin(), data.players[dir].end(), [](const auto& a, const auto& b) { return a.traffic.bytes > b.traffic.bytes; });
+	}
+
+	return data;
+}
+
+std::string net::stats::CTrafficStats::Format(const report& data, std::size_t top) const
+{
+	std::string out = fmt::format("Network traffic over the last {}s\n", data.window.count());
+	const auto seconds = std::max<long long>(data.window.count(), 1);
+
+	for (std::uint8_t dir = 0; dir < 2; ++dir)
+	{
+		out += fmt::format("  {}: {} messages, {} bytes ({:.1f} KB/s)\n", (dir == incoming ? "IN" : "OUT"), data.totals[dir].messages, data.totals[dir].bytes, data.totals[dir].bytes / 1024.0 / seconds);
+
+		for (std::size_t i = 0; i < std::min(top, data.ids[dir].size()); ++i)
+		{
+			auto& entry = data.ids[dir][i];
+			out += fmt::format("    {} {:>3}: {:>8} messages {:>10} bytes\n", (entry.type == rpc ? "RPC   " : "PACKET"), entry.id, entry.traffic.messages, entry.traffic.bytes);
+		}
+
+		for (std::size_t i = 0; i < std::min(top, data.players[dir].size()); ++i)
+		{
+			auto& entry = data.players[dir][i];
+			out += fmt::format("    player {:>3}: {:>8} messages {:>10} bytes\n", entry.playerid, entry.traffic.messages, entry.traffic.bytes);
+		}
+	}
+
+	return out;
+}
+
+static public_hook _ns_ogmi("OnGameModeInit", +[]() -> cell {
+	timers::timer_manager->Repeat(1000, 1000, [](timers::CTimer*) {
+		net::stats::traffic.Sample();
+	});
+
+	// Dump the last window to a log file once per window, the writing happens in the thread pool
+	timers::timer_manager->Repeat(net::stats::CTrafficStats::WINDOW_SECONDS * 1000, net::stats::CTrafficStats::WINDOW_SECONDS * 1000, [](timers::CTimer*) {
+		uv_work_t* work = new uv_work_t;
+		work->data = new std::string(fmt::format("[{:%Y-%m-%d %H:%M:%S}] {}\n", fmt::localtime(std::time(nullptr)), net::stats::traffic.Format(net::stats::traffic.Report())));
+
+		uv_queue_work(uv_default_loop(), work, [](uv_work_t* handle) {
+			auto* text = static_cast<std::string*>(handle->data);
+
+			std::error_code ec;
+			std::filesystem::create_directories("scriptfiles/logs", ec);
+			std::ofstream log{ "scriptfiles/logs/netstats.log", std::ios::app };
+			log << *text;
+		},
+		[](uv_work_t* handle, int /*status*/) {
+			delete static_cast<std::string*>(handle->data);
+			delete handle;
+		});
+	});
+
+	return 1;
+});
+
+static command netstats_cmd("netstats", command::make_flag<player::rank::admin>, [](CPlayer* player, cmd::argument_store args) {
+	auto data = net::stats::traffic.Report();
+	if (data.window.count() == 0)
+	{
+		player->Chat()->Send(0xED2B2BFF, "[ERROR] {DADADA}Todava no hay suficientes datos de trfico.");
+		return;
+	}
+
+	const auto seconds = data.window.count();
+	player->Chat()->Send(0xDADADAFF, "Trfico de red de los ltimos {{ED2B2B}}{}s{{DADADA}}:", seconds);
+
+	for (std::uint8_t dir = 0; dir < 2; ++dir)
+	{
+		player->Chat()->Send(0xDADADAFF, "{{ED2B2B}}{}{{DADADA}}: {} mensajes, {:.1f} KB/s", (dir == net::stats::incoming ? "Entrante" : "Saliente"), data.totals[dir].messages, data.totals[dir].bytes / 1024.0 / seconds);
+
+		for (std::size_t i = 0; i < std::min<std::size_t>(5u, data.ids[dir].size()); ++i)
+		{
+			auto& entry = data.ids[dir][i];
+			player->Chat()->Send(0xDADADAFF, "   {} {}: {} mensajes, {:.1f} KB/s", (entry.type == net::stats::rpc ? "RPC" : "Paquete"), entry.id, entry.traffic.messages, entry.traffic.bytes / 1024.0 / seconds);
+		}
+
+		if (!data.players[dir].empty())
+		{
+			auto& top = data.players[dir].front();
+			player->Chat()->Send(0xDADADAFF, "   Jugador con ms trfico: {} ({:.1f} KB/s)", top.playerid, top.traffic.bytes / 1024.0 / seconds);
+		}
+	}
+});
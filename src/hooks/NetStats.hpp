@@ -0,0 +1,105 @@
+#pragma once
+
+namespace net::stats
+{
+	enum direction : std::uint8_t
+	{
+		incoming = 0,
+		outgoing = 1
+	};
+
+	// Packet and RPC IDs overlap, so they are accounted separately
+	enum kind : std::uint8_t
+	{
+		packet = 0,
+		rpc = 1
+	};
+
+	struct sample
+	{
+		std::uint32_t messages{ 0u };
+		std::uint32_t bytes{ 0u };
+	};
+
+	struct id_sample
+	{
+		kind type;
+		std::uint8_t id;
+		sample traffic;
+	};
+
+	struct player_sample
+	{
+		std::uint16_t playerid;
+		sample traffic;
+	};
+
+	struct report
+	{
+		std::chrono::seconds window{ 0 };
+		std::array<sample, 2> totals{};
+		std::array<std::vector<id_sample>, 2> ids;			// Sorted by bytes, descending
+		std::array<std::vector<player_sample>, 2> players;	// Sorted by bytes, descending
+	};
+
+	// Counts messages and bytes per packet/RPC ID and per player slot, in both directions. Outgoing messages are
+	// counted in the RakServer Send and RPC hooks as well as in our wrappers, so the sync and RPCs the server core
+	// sends by itself are included. Broadcasts only count once and towards no player.
+	// The counters are only ever incremented, the rolling window is the difference between the newest
+	// and the oldest of the per-second snapshots.
+	class CTrafficStats
+	{
+	public:
+		static constexpr std::size_t WINDOW_SECONDS = 60u;
+
+	private:
+		struct counter
+		{
+			std::atomic<std::uint32_t> messages{ 0u };
+			std::atomic<std::uint32_t> bytes{ 0u };
+
+			inline sample load() const
+			{
+				return { messages.load(std::memory_order_relaxed), bytes.load(std::memory_order_relaxed) };
+			}
+		};
+
+		struct snapshot
+		{
+			std::array<std::array<std::array<sample, 256>, 2>, 2> ids;
+			std::array<std::array<sample, 2>, MAX_PLAYERS> players;
+		};
+
+		std::array<std::array<std::array<counter, 256>, 2>, 2> _ids; // [kind][direction][id]
+		std::array<std::array<counter, 2>, MAX_PLAYERS> _players; // [player][direction]
+
+		std::vector<snapshot> _snapshots;
+		std::size_t _head{ 0u };
+		std::size_t _filled{ 0u };
+
+	public:
+		CTrafficStats() : _snapshots(WINDOW_SECONDS + 1) {}
+		~CTrafficStats() = default;
+
+		inline void Count(kind type, direction dir, std::uint8_t id, std::uint16_t playerid, std::size_t bytes)
+		{
+			auto& by_id = _ids[type][dir][id];
+			by_id.messages.fetch_add(1u, std::memory_order_relaxed);
+			by_id.bytes.fetch_add(static_cast<std::uint32_t>(bytes), std::memory_order_relaxed);
+
+			if (playerid < MAX_PLAYERS)
+			{
+				auto& by_player = _players[playerid][dir];
+				by_player.messages.fetch_add(1u, std::memory_order_relaxed);
+				by_player.bytes.fetch_add(static_cast<std::uint32_t>(bytes), std::memory_order_relaxed);
+			}
+		}
+
+		// Called once per second
+		void Sample();
+		report Report() const;
+		std::string Format(const report& data, std::size_t top = 10u) const;
+	};
+
+	extern CTrafficStats traffic;
+}
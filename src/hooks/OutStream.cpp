@@ -0,0 +1,34 @@
+#include "../main.hpp"
+
+thread_local net::detail::CBufferPool net::detail::pooled_buffer::pool{};
+
+net::detail::CBufferPool::~CBufferPool()
+{
+	for (auto&& buf : _free)
+	{
+		std::free(buf.data);
+	}
+}
+
+std::pair<unsigned char*, std::size_t> net::detail::CBufferPool::Acquire()
+{
+	if (_free.empty())
+	{
+		return { static_cast<unsigned char*>(std::malloc(BUFFER_SIZE)), BUFFER_SIZE };
+	}
+
+	auto buf = _free.back();
+	_free.pop_back();
+	return { buf.data, buf.capacity };
+}
+
+void net::detail::CBufferPool::Release(unsigned char* data, std::size_t capacity)
+{
+	if (_free.size() >= MAX_POOLED)
+	{
+		std::free(data);
+		return;
+	}
+
+	_free.push_back({ data, capacity });
+}
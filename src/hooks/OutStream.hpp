@@ -0,0 +1,66 @@
+#pragma once
+
+namespace net
+{
+	namespace detail
+	{
+		// Per-thread free list of malloc'd buffers. BitStream grows non-stack buffers with realloc, so any
+		// buffer handed out here may come back bigger (and at a different address) than it left.
+		class CBufferPool
+		{
+			struct buffer
+			{
+				unsigned char* data;
+				std::size_t capacity;
+			};
+
+			std::vector<buffer> _free;
+
+		public:
+			// Big enough for a textdraw show RPC carrying the longest string the client accepts
+			static constexpr std::size_t BUFFER_SIZE = 2048u;
+			static constexpr std::size_t MAX_POOLED = 16u;
+
+			CBufferPool() { _free.reserve(MAX_POOLED); }
+			~CBufferPool();
+
+			std::pair<unsigned char*, std::size_t> Acquire();
+			void Release(unsigned char* data, std::size_t capacity);
+		};
+
+		struct pooled_buffer
+		{
+			static thread_local CBufferPool pool;
+
+			unsigned char* _buffer;
+			std::size_t _capacity;
+
+			pooled_buffer()
+			{
+				std::tie(_buffer, _capacity) = pool.Acquire();
+			}
+		};
+	}
+
+	// Drop-in replacement for a BitStream used to build outgoing messages. The payload is written into a
+	// pooled buffer instead of the inline stack area, so large messages don't hit the allocator either.
+	class OutStream final : private detail::pooled_buffer, public BitStream
+	{
+	public:
+		OutStream()
+			: detail::pooled_buffer(), BitStream(_buffer, static_cast<unsigned int>(_capacity), false)
+		{
+			ResetWritePointer();
+		}
+
+		~OutStream()
+		{
+			// Writes past the capacity realloc'd the buffer, keep whatever BitStream ended up with
+			auto* data = GetData();
+			pool.Release(data, (data == _buffer ? _capacity : std::max<std::size_t>(_capacity, GetNumberOfBytesUsed())));
+		}
+
+		OutStream(const OutStream&) = delete;
+		OutStream& operator=(const OutStream&) = delete;
+	};
+}
@@ -0,0 +1,142 @@
+#include "../main.hpp"
+
+net::capture::CPacketRecorder net::capture::recorder{};
+
+net::capture::CPacketRecorder::~CPacketRecorder()
+{
+	Stop();
+}
+
+bool net::capture::CPacketRecorder::Start(const std::filesystem::path& path)
+{
+	if (Recording())
+		Stop();
+
+	std::error_code ec;
+	std::filesystem::create_directories(path.parent_path(), ec);
+
+	// The stream buffer has to be installed before the file is opened
+	_buffer = std::make_unique<char[]>(WRITE_BUFFER_SIZE);
+	_file.rdbuf()->pubsetbuf(_buffer.get(), WRITE_BUFFER_SIZE);
+	_file.open(path, std::ios::binary | std::ios::trunc);
+	if (!_file)
+	{
+		sampgdk::logprintf("[capture] Couldn't open capture file %s.", path.string().c_str());
+		_buffer.reset();
+		return false;
+	}
+
+	stCaptureHeader header{};
+	header.start_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	_path = path;
+	_start = std::chrono::steady_clock::now();
+	_packets = _bytes = 0u;
+
+	sampgdk::logprintf("[capture] Recording incoming packets to %s.", _path.string().c_str());
+	return true;
+}
+
+void net::capture::CPacketRecorder::Stop()
+{
+	if (!Recording())
+		return;
+
+	_file.close();
+	_buffer.reset();
+
+	sampgdk::logprintf("[capture] Stopped recording: %u packets (%u bytes) written to %s.", _packets, _bytes, _path.string().c_str());
+}
+
+void net::capture::CPacketRecorder::Record(std::uint16_t playerid, std::uint8_t packetid, const unsigned char* data, std::size_t length)
+{
+	if (!Recording() || length > std::numeric_limits<std::uint16_t>::max())
+		return;
+
+	stCaptureRecord record;
+	record.timestamp = static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _start).count());
+	record.playerid = playerid;
+	record.packetid = packetid;
+	record.length = static_cast<std::uint16_t>(length);
+
+	_file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+	_file.write(reinterpret_cast<const char*>(data), length);
+
+	++_packets;
+	_bytes += sizeof(record) + length;
+}
+
+net::capture::CCaptureReader::CCaptureReader(const std::filesystem::path& path)
+	: _file(path, std::ios::binary)
+{
+	if (!_file)
+		throw std::runtime_error{ "couldn't open capture file" };
+
+	if (!_file.read(reinterpret_cast<char*>(&_header), sizeof(_header)) || _header.magic != CAPTURE_MAGIC)
+		throw std::runtime_error{ "not a packet capture file" };
+
+	if (_header.version != CAPTURE_VERSION)
+		throw std::runtime_error{ "unsupported packet capture version" };
+}
+
+bool net::capture::CCaptureReader::Next(stCaptureRecord& record, std::vector<unsigned char>& payload)
+{
+	if (!_file.read(reinterpret_cast<char*>(&record), sizeof(record)))
+		return false;
+
+	payload.resize(record.length);
+	return !!_file.read(reinterpret_cast<char*>(payload.data()), record.length);
+}
+
+static command capturecmd("capture", command::make_flag<player::rank::admin>, [](CPlayer* player, cmd::argument_store args) {
+	std::string action;
+
+	try
+	{
+		args >> action;
+	}
+	catch (const std::exception& e)
+	{
+		player->Chat()->Send(0xDADADAFF, "USO: {ED2B2B}/capture{DADADA} <start/stop/status>");
+		return;
+	}
+
+	auto& recorder = net::capture::recorder;
+
+	if (action == "start")
+	{
+		auto filename = fmt::format("{:%Y%m%d-%H%M%S}.cap", fmt::localtime(std::time(nullptr)));
+		if (!recorder.Start(std::filesystem::current_path() / "scriptfiles" / "captures" / filename))
+		{
+			player->Chat()->Send(0xED2B2BFF, "[ERROR] {DADADA}No se pudo crear el archivo de captura.");
+			return;
+		}
+
+		player->Chat()->Send(0xDADADAFF, "Capturando paquetes entrantes en {{ED2B2B}}{}{{DADADA}}.", filename);
+	}
+	else if (action == "stop")
+	{
+		if (!recorder.Recording())
+		{
+			player->Chat()->Send(0xED2B2BFF, "[ERROR] {DADADA}No hay ninguna captura en curso.");
+			return;
+		}
+
+		auto packets = recorder.RecordedPackets();
+		auto bytes = recorder.RecordedBytes();
+		recorder.Stop();
+		player->Chat()->Send(0xDADADAFF, "Captura terminada: {{ED2B2B}}{}{{DADADA}} paquetes, {{ED2B2B}}{}{{DADADA}} KB.", packets, bytes / 1024);
+	}
+	else if (action == "status")
+	{
+		if (recorder.Recording())
+			player->Chat()->Send(0xDADADAFF, "Captura en curso: {{ED2B2B}}{}{{DADADA}} paquetes en {}.", recorder.RecordedPackets(), recorder.Path().filename().string());
+		else
+			player->Chat()->Send(0xDADADAFF, "No hay ninguna captura en curso.");
+	}
+	else
+	{
+		player->Chat()->Send(0xDADADAFF, "USO: {ED2B2B}/capture{DADADA} <start/stop/status>");
+	}
+});
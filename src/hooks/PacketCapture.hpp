@@ -0,0 +1,65 @@
+#pragma once
+
+namespace net::capture
+{
+	constexpr std::uint32_t CAPTURE_MAGIC = 'THPC';
+	constexpr std::uint16_t CAPTURE_VERSION = 1;
+
+#pragma pack(push, 1)
+	struct stCaptureHeader
+	{
+		std::uint32_t magic{ CAPTURE_MAGIC };
+		std::uint16_t version{ CAPTURE_VERSION };
+		std::uint16_t max_players{ MAX_PLAYERS };
+		std::int64_t start_time{ 0 }; // Unix time, milliseconds
+	};
+
+	// Each record is followed by `length` bytes of payload, which include the packet ID byte.
+	struct stCaptureRecord
+	{
+		std::uint32_t timestamp; // Milliseconds since the capture started
+		std::uint16_t playerid;
+		std::uint8_t packetid;
+		std::uint16_t length;
+	};
+#pragma pack(pop)
+
+	class CPacketRecorder
+	{
+		static constexpr std::size_t WRITE_BUFFER_SIZE = 64 * 1024;
+
+		std::ofstream _file;
+		std::unique_ptr<char[]> _buffer;
+		std::filesystem::path _path;
+		std::chrono::steady_clock::time_point _start;
+		std::size_t _packets{ 0u };
+		std::size_t _bytes{ 0u };
+
+	public:
+		CPacketRecorder() = default;
+		~CPacketRecorder();
+
+		bool Start(const std::filesystem::path& path);
+		void Stop();
+		void Record(std::uint16_t playerid, std::uint8_t packetid, const unsigned char* data, std::size_t length);
+
+		inline bool Recording() const { return _file.is_open(); }
+		inline std::size_t RecordedPackets() const { return _packets; }
+		inline std::size_t RecordedBytes() const { return _bytes; }
+		inline const std::filesystem::path& Path() const { return _path; }
+	};
+
+	class CCaptureReader
+	{
+		std::ifstream _file;
+		stCaptureHeader _header{};
+
+	public:
+		explicit CCaptureReader(const std::filesystem::path& path);
+
+		bool Next(stCaptureRecord& record, std::vector<unsigned char>& payload);
+		inline const stCaptureHeader& Header() const { return _header; }
+	};
+
+	extern CPacketRecorder recorder;
+}
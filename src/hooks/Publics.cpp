@@ -97,5 +97,9 @@ PLUGIN_EXPORT bool PLUGIN_CALL OnPublicCall(AMX* amx, const char* name, cell* pa
 PLUGIN_EXPORT bool PLUGIN_CALL OnPlayerDisconnect(int playerid, int reason)
 {
 	server::player_pool.Remove(playerid);
+	// Removing the player hides its textdraws, which queues RPCs nobody is going to receive
+	net::rpc_queue.Discard(playerid);
+	server::spatial::player_grid.Remove(playerid);
+	vehicles::occupancy.Leave(playerid);
 	return true;
 }
@@ -0,0 +1,130 @@
+#include "../main.hpp"
+
+net::CRpcQueue net::rpc_queue{};
+
+std::optional<std::uint16_t> net::CRpcQueue::GetTextDrawId(unsigned char rpcid, const unsigned char* data, int bits)
+{
+	switch (rpcid)
+	{
+		case raknet::RPC_ShowTextDraw:
+		case raknet::RPC_TextDrawHideForPlayer:
+		case raknet::RPC_TextDrawSetString:
+		{
+			if (bits < 16)
+				return std::nullopt;
+
+			std::uint16_t textdrawid;
+			std::memcpy(&textdrawid, data, sizeof(textdrawid));
+			return textdrawid;
+		}
+	}
+
+	return std::nullopt;
+}
+
+net::send_policy net::CRpcQueue::GetPolicy(BitStream* bs, unsigned char rpcid, message_class type)
+{
+	if (type == message_class::hud_state || type == message_class::hud_frame || type == message_class::hud_final)
+	{
+		if (auto textdrawid = GetTextDrawId(rpcid, bs->GetData(), bs->GetNumberOfBitsUsed()))
+			return GetTextDrawSendPolicy(type, *textdrawid);
+	}
+
+	return GetSendPolicy(type);
+}
+
+void net::CRpcQueue::Supersede(player_queue& queue, unsigned char rpcid, std::uint16_t textdrawid)
+{
+	// Showing or hiding a textdraw replaces everything queued for it before, a new string only replaces the previous string
+	const bool replaces_all = (rpcid != raknet::RPC_TextDrawSetString);
+
+	for (auto&& rpc : queue.rpcs)
+	{
+		if (rpc.superseded)
+			continue;
+
+		if (!replaces_all && rpc.rpcid != raknet::RPC_TextDrawSetString)
+			continue;
+
+		auto id = GetTextDrawId(rpc.rpcid, queue.data.data() + rpc.offset, rpc.bits);
+		if (id && *id == textdrawid)
+		{
+			rpc.superseded = true;
+			++_coalesced;
+		}
+	}
+}
+
+void net::CRpcQueue::Push(BitStream* bs, unsigned char rpcid, std::uint16_t playerid, std::size_t count, PacketPriority priority, PacketReliability reliability, unsigned ordering_channel)
+{
+	if (playerid >= MAX_PLAYERS || count == 0u)
+		return;
+
+	auto& queue = _queues[playerid];
+
+	if (auto textdrawid = GetTextDrawId(rpcid, bs->GetData(), bs->GetNumberOfBitsUsed()))
+	{
+		Supersede(queue, rpcid, *textdrawid);
+	}
+
+	const auto bytes = bs->GetNumberOfBytesUsed();
+	queue.rpcs.push_back({ rpcid, priority, reliability, ordering_channel, queue.data.size(), bs->GetNumberOfBitsUsed(), count, false });
+	queue.data.insert(queue.data.end(), bs->GetData(), bs->GetData() + bytes);
+
+	_pending.set(playerid);
+	_pushed += count;
+	++_queued;
+}
+
+void net::CRpcQueue::Discard(std::uint16_t playerid)
+{
+	if (playerid >= MAX_PLAYERS)
+		return;
+
+	_queues[playerid].rpcs.clear();
+	_queues[playerid].data.clear();
+	_pending.reset(playerid);
+}
+
+void net::CRpcQueue::Flush()
+{
+	Process(true);
+}
+
+void net::CRpcQueue::Process(bool send)
+{
+	if (_pending.none())
+		return;
+
+	for (std::uint16_t playerid = 0; playerid < MAX_PLAYERS; ++playerid)
+	{
+		if (!_pending.test(playerid))
+			continue;
+
+		auto& queue = _queues[playerid];
+
+		for (auto&& rpc : queue.rpcs)
+		{
+			if (rpc.superseded)
+				continue;
+
+			if (send)
+			{
+				BitStream bs{ queue.data.data() + rpc.offset, static_cast<unsigned int>((rpc.bits + 7) >> 3), false };
+				bs.SetWriteOffset(rpc.bits);
+				for (std::size_t i = 0; i < rpc.count; ++i)
+				{
+					RakServer->SendRPC(&bs, rpc.rpcid, static_cast<int>(playerid), rpc.priority, rpc.reliability, rpc.ordering_channel);
+				}
+			}
+
+			_sent += rpc.count;
+		}
+
+		// Keep the capacity around, the same players tend to receive RPCs every tick
+		queue.rpcs.clear();
+		queue.data.clear();
+	}
+
+	_pending.reset();
+}
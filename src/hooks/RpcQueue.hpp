@@ -0,0 +1,72 @@
+#pragma once
+
+namespace net
+{
+	// Collects the RPCs sent to each player during a server tick and hands them to RakNet at once from ProcessTick.
+	// Textdraw RPCs made obsolete by a later one for the same textdraw ID are dropped instead of being sent.
+	class CRpcQueue
+	{
+		struct queued_rpc
+		{
+			unsigned char rpcid;
+			PacketPriority priority;
+			PacketReliability reliability;
+			unsigned ordering_channel;
+			std::size_t offset;
+			int bits;
+			std::size_t count; // Times it's sent, repeated RPCs are only stored once
+			bool superseded;
+		};
+
+		struct player_queue
+		{
+			std::vector<queued_rpc> rpcs;
+			std::vector<unsigned char> data;
+		};
+
+		std::array<player_queue, MAX_PLAYERS> _queues;
+		std::bitset<MAX_PLAYERS> _pending;
+		std::size_t _pushed{ 0u };
+		std::size_t _queued{ 0u }; // Entries, a repeated RPC counts once
+		std::size_t _sent{ 0u };
+		std::size_t _coalesced{ 0u };
+
+		static std::optional<std::uint16_t> GetTextDrawId(unsigned char rpcid, const unsigned char* data, int bits);
+		// Textdraw RPCs are routed by their ID, see GetTextDrawSendPolicy
+		static send_policy GetPolicy(BitStream* bs, unsigned char rpcid, message_class type);
+		void Supersede(player_queue& queue, unsigned char rpcid, std::uint16_t textdrawid);
+		void Push(BitStream* bs, unsigned char rpcid, std::uint16_t playerid, std::size_t count, PacketPriority priority, PacketReliability reliability, unsigned ordering_channel);
+		void Process(bool send);
+
+	public:
+		CRpcQueue() = default;
+		~CRpcQueue() = default;
+
+		inline void Push(BitStream* bs, unsigned char rpcid, std::uint16_t playerid, PacketPriority priority = HIGH_PRIORITY, PacketReliability reliability = RELIABLE, unsigned ordering_channel = 0)
+		{
+			Push(bs, rpcid, playerid, 1u, priority, reliability, ordering_channel);
+		}
+		inline void Push(BitStream* bs, unsigned char rpcid, std::uint16_t playerid, message_class type)
+		{
+			const auto policy = GetPolicy(bs, rpcid, type);
+			Push(bs, rpcid, playerid, 1u, policy.priority, policy.reliability, policy.ordering_channel);
+		}
+		// Sends the same RPC `count` times in a row while queuing it once, for bulk operations such as clearing the chat
+		inline void PushRepeated(BitStream* bs, unsigned char rpcid, std::uint16_t playerid, std::size_t count, message_class type)
+		{
+			const auto policy = GetPolicy(bs, rpcid, type);
+			Push(bs, rpcid, playerid, count, policy.priority, policy.reliability, policy.ordering_channel);
+		}
+		void Discard(std::uint16_t playerid);
+		void Flush();
+		// Empties the queue counting what Flush would have sent, for benchmarks that use a queue of their own
+		inline void Drain() { Process(false); }
+
+		inline std::size_t PushedCount() const { return _pushed; }
+		inline std::size_t QueuedCount() const { return _queued; }
+		inline std::size_t SentCount() const { return _sent; }
+		inline std::size_t CoalescedCount() const { return _coalesced; }
+	};
+
+	extern CRpcQueue rpc_queue;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+namespace net
+{
+	// What kind of message is being sent, decides how RakNet delivers it
+	enum class message_class : std::uint8_t
+	{
+		hud_state,		// Textdraw shown, hidden or changed
+		hud_frame,		// Intermediate frame of a textdraw animation, stale as soon as the next one is sent
+		hud_final,		// Any other message for an animated textdraw, including the last frame
+		chat,
+		dialog,
+
+		max_class
+	};
+
+	struct send_policy
+	{
+		PacketPriority priority;
+		PacketReliability reliability;
+		unsigned ordering_channel;
+	};
+
+	// The server core only sends on the first channels, chat and dialogs share channel 0 with it
+	constexpr unsigned FIRST_HUD_CHANNEL = 4u;
+	constexpr unsigned HUD_CHANNELS = 8u;
+	constexpr unsigned FIRST_ANIMATION_CHANNEL = FIRST_HUD_CHANNEL + HUD_CHANNELS;
+	constexpr unsigned ANIMATION_CHANNELS = 32u - FIRST_ANIMATION_CHANNEL;
+
+	// The textdraw index manager keeps the last IDs for animated textdraws, one per animation channel
+	constexpr std::uint16_t TEXTDRAW_IDS = 2304;
+	constexpr std::uint16_t FIRST_ANIMATION_TEXTDRAW_ID = TEXTDRAW_IDS - ANIMATION_CHANNELS;
+
+	// Fallbacks for messages that don't carry a textdraw ID, textdraw RPCs go through GetTextDrawSendPolicy
+	constexpr std::array<send_policy, static_cast<std::size_t>(message_class::max_class)> send_policies = { {
+		{ HIGH_PRIORITY, RELIABLE_ORDERED, FIRST_HUD_CHANNEL },			// hud_state
+		{ HIGH_PRIORITY, RELIABLE_ORDERED, FIRST_HUD_CHANNEL },			// hud_frame
+		{ HIGH_PRIORITY, RELIABLE_ORDERED, FIRST_HUD_CHANNEL },			// hud_final
+		{ HIGH_PRIORITY, RELIABLE_ORDERED, 0u },						// chat
+		{ HIGH_PRIORITY, RELIABLE_ORDERED, 0u }							// dialog
+	} };
+
+	constexpr const send_policy& GetSendPolicy(message_class type)
+	{
+		return send_policies[static_cast<std::size_t>(type)];
+	}
+
+	// An animation ID has a sequenced channel to itself: frames go unreliable, everything else reliable, and the
+	// client drops whatever is older than the last message it got. Nothing but that ID is sent there, so a late
+	// frame can't land after the last frame or the hide, and a final message is only dropped for a newer full
+	// show or hide of the same ID. That includes the next textdraw that gets the ID.
+	// Other IDs keep their messages in order, a string must not arrive before its show nor a hide after the
+	// show that reuses the ID. They are spread over several channels by ID, so a lost update only holds back
+	// the textdraws that share its channel. Animated textdraws that didn't get an animation ID end up here too,
+	// with their frames sent reliably.
+	constexpr send_policy GetTextDrawSendPolicy(message_class type, std::uint16_t textdrawid)
+	{
+		if (textdrawid >= FIRST_ANIMATION_TEXTDRAW_ID && textdrawid < TEXTDRAW_IDS)
+		{
+			return { HIGH_PRIORITY, (type == message_class::hud_frame ? UNRELIABLE_SEQUENCED : RELIABLE_SEQUENCED), FIRST_ANIMATION_CHANNEL + (textdrawid - FIRST_ANIMATION_TEXTDRAW_ID) };
+		}
+
+		return { HIGH_PRIORITY, RELIABLE_ORDERED, FIRST_HUD_CHANNEL + textdrawid % HUD_CHANNELS };
+	}
+}
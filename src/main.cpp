@@ -23,6 +23,8 @@ PLUGIN_EXPORT bool PLUGIN_CALL Load(void** ppData)
 
 PLUGIN_EXPORT void PLUGIN_CALL Unload()
 {
+	server::journal::writer.Stop();
+
 	if (uv_loop_close(uv_default_loop()) == UV_EBUSY)
 	{
 		uv_walk(uv_default_loop(), [](uv_handle_t* h, void* /*arg*/) {
@@ -50,6 +52,8 @@ PLUGIN_EXPORT void PLUGIN_CALL ProcessTick()
 {
 	// sampgdk::ProcessTick();
 	uv_run(uv_default_loop(), UV_RUN_NOWAIT);
+	server::BaseTextDraw::FlushAll();
+	net::rpc_queue.Flush();
 }
 
 // -
@@ -122,7 +122,13 @@ class CPlayer;
 class CVehicle;
 
 #include "hooks/RakUtil.hpp"
+#include "hooks/NetStats.hpp"
+#include "hooks/SendPolicy.hpp"
 #include "hooks/CRakServer.hpp"
+#include "hooks/OutStream.hpp"
+#include "hooks/PacketCapture.hpp"
+#include "hooks/RpcQueue.hpp"
+#include "hooks/Multicast.hpp"
 #include "hooks/CConsole.hpp"
 #include "hooks/Publics.hpp"
 #include "hooks/Server.hpp"
@@ -130,17 +136,27 @@ class CVehicle;
 #include "server/natives/streamer/Natives.hpp"
 #include "server/natives/colandreas/Natives.hpp"
 #include "server/Database.hpp"
+#include "server/JournalFormat.hpp"
+#include "server/Journal.hpp"
 #include "server/commands/ArgumentStore.hpp"
 #include "server/commands/Commands.hpp"
 #include "server/timers/Timer.hpp"
+#include "server/natives/colandreas/Heightmap.hpp"
+#include "server/spatial/PlayerGrid.hpp"
+#include "server/spatial/Zones.hpp"
 #include "server/textdraws/TextDrawManager.hpp"
 #include "server/textdraws/TextDraw.hpp"
+#include "server/textdraws/TextDrawLayout.hpp"
+#include "server/textdraws/TextMeasure.hpp"
 #include "server/EnterExitManager.hpp"
 #include "server/shops/ShopManager.hpp"
+#include "server/vehicles/Occupancy.hpp"
 #include "server/vehicles/CVehicle.hpp"
 #include "server/vehicles/CPlayerVehicleManager.hpp"
 
 #include "player/CFadeScreen.hpp"
+#include "player/ChatFilter.hpp"
+#include "player/CChatHistory.hpp"
 #include "player/CChat.hpp"
 #include "player/Notifications.hpp"
 #include "player/Needs.hpp"
@@ -18,6 +18,7 @@
 #include <memory>
 #include <array>
 #include <any>
+#include <variant>
 #include <optional>
 #include <regex>
 #include <stack>
@@ -25,12 +26,14 @@
 #include <cstring>
 #include <cstdint>
 #include <queue>
+#include <deque>
 #include <bit>
 #include <numbers>
 #include <syncstream>
 #include <charconv>
 #include <concepts>
 #include <numeric>
+#include <span>
 
 #else
 
@@ -45,4 +48,8 @@
 #elif defined __linux__
 	#include <sys/socket.h>
 	#include <netinet/in.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
 #endif
@@ -1,13 +1,8 @@
 #include "../main.hpp"
 
-void CChat::PushMessage(std::uint32_t color, const std::string& message)
+void CChat::PushMessage(std::uint32_t color, std::string_view message)
 {
-	if (_chatbuffer.size() == chatbuffer_size)
-	{
-		_chatbuffer.pop_front();
-	}
-
-	_chatbuffer.push_back(chat_message{ color, message });
+	_history.Push(color, message);
 }
 
 std::vector<std::string> CChat::SplitChatMessage(const std::string& text, std::uint8_t max_line_length)
@@ -39,11 +34,11 @@ std::vector<std::string> CChat::SplitChatMessage(const std::string& text, std::u
 
 void CChat::Send(std::uint32_t color, const std::string& message)
 {
-	BitStream bs;
+	net::OutStream bs;
 	bs.Write<std::uint32_t>(color);
 	bs.Write<std::uint32_t>(message.length());
 	bs.Write(message.c_str(), message.length());
-	net::RakServer->SendRPC(&bs, net::raknet::RPC_ClientMessage, _player->PlayerId());
+	net::rpc_queue.Push(&bs, net::raknet::RPC_ClientMessage, _player->PlayerId(), net::message_class::chat);
 
 	if (_register_messages)
 	{
@@ -51,86 +46,116 @@ void CChat::Send(std::uint32_t color, const std::string& message)
 	}
 }
 
+void CChat::SendBlankLines(std::size_t count, net::CRpcQueue& queue)
+{
+	net::OutStream bs;
+	bs.Write<uint32_t>(0);
+	bs.Write<uint32_t>(1);
+	bs.Write(" ", 1);
+	queue.PushRepeated(&bs, net::raknet::RPC_ClientMessage, _player->PlayerId(), count, net::message_class::chat);
+}
+
 void CChat::Resend()
 {
-	for(auto&& msg : _chatbuffer)
+	// Lines from before the chat was cleared must not show up again, push them out of the client's window
+	if (_history.Cleared() && _history.Size() < client_chat_lines)
 	{
-		BitStream bs;
-		bs.Write<uint32_t>(msg.color);
-		bs.Write<uint32_t>(msg.message.length());
-		bs.Write(msg.message.c_str(), msg.message.length());
-		net::RakServer->SendRPC(&bs, net::raknet::RPC_ClientMessage, _player->PlayerId());
+		SendBlankLines(client_chat_lines - _history.Size());
 	}
+
+	const auto playerid = _player->PlayerId();
+	_history.ForEach([playerid](std::uint32_t color, std::string_view message) {
+		net::OutStream bs;
+		bs.Write<uint32_t>(color);
+		bs.Write<uint32_t>(message.length());
+		bs.Write(message.data(), message.length());
+		net::rpc_queue.Push(&bs, net::raknet::RPC_ClientMessage, playerid, net::message_class::chat);
+	});
 }
 
 void CChat::Flush()
 {
-	_chatbuffer.clear();
+	_history.Clear();
 }
 
-void CChat::Clear()
+void CChat::Clear(net::CRpcQueue& queue)
 {
-	BitStream bs;
-	bs.Write<uint32_t>(0);
-	bs.Write<uint32_t>(1);
-	bs.Write(" ", 1);
-
-	_chatbuffer.clear();
-
-	for (size_t i = 0; i < chatbuffer_size; ++i)
-	{
-		net::RakServer->SendRPC(&bs, net::raknet::RPC_ClientMessage, _player->PlayerId());
-		_chatbuffer.push_back(chat_message{ 0, " " });
-	}
+	SendBlankLines(client_chat_lines, queue);
+	_history.MarkCleared();
 }
 
 void CChat::SendRangedMessage(std::uint32_t color, float range, const std::string& text)
 {
-	auto& pos = _player->Position();
+	SendRangedMessage(color, range, std::vector<std::string>{ text });
+}
 
-	for (auto&& [id, player] : server::player_pool)
-	{
-		float distance = GetPlayerDistanceFromPoint(id, pos.x, pos.y, pos.z);
-		if (distance > range)
-			continue;
+void CChat::SendRangedMessage(std::uint32_t color, float range, const std::vector<std::string>& messages)
+{
+	auto& pos = _player->Position();
+	net::Multicast::recipients recipients;
+	std::array<std::uint32_t, MAX_PLAYERS> colors;
 
+	const auto playerid = _player->PlayerId();
+	server::spatial::player_grid.ForEachInRadius(GetPlayerVirtualWorld(playerid), GetPlayerInterior(playerid), { pos.x, pos.y, pos.z }, range, [&](std::uint16_t id, float distance) {
 		int alpha = (255 - (distance * 3.0));
 #define RGBToHex(r,g,b) (0xFF | ((b) << 8) | ((g) << 16) | ((r) << 24))
 #define Darken(col,alpha) ((col) & RGBToHex(alpha,alpha,alpha))
 
-		player->Chat()->Send(Darken(color, alpha), text);
+		colors[id] = Darken(color, alpha);
+		recipients.set(id);
 
 #undef RGBToHex
 #undef Darken
-	}
-}
+	});
 
-void CChat::SendRangedMessage(std::uint32_t color, float range, const std::vector<std::string>& messages)
-{
-	auto& pos = _player->Position();
-
-	for (auto&& [id, player] : server::player_pool)
+	// The sender hears itself even before its first sync packet made it into the grid
+	if (!recipients.test(playerid))
 	{
-		float distance = GetPlayerDistanceFromPoint(id, pos.x, pos.y, pos.z);
-		if (distance > range)
-			continue;
-
-		int alpha = (255 - (distance * 3.0));
-#define RGBToHex(r,g,b) (0xFF | ((b) << 8) | ((g) << 16) | ((r) << 24))
-#define Darken(col,alpha) ((col) & RGBToHex(alpha,alpha,alpha))
+		colors[playerid] = color;
+		recipients.set(playerid);
+	}
 
-		for (auto&& text : messages)
+	// Serialize every line once, only the darkened color changes between recipients
+	for (auto&& text : messages)
+	{
+		net::OutStream bs;
+		bs.Write<std::uint32_t>(0);
+		bs.Write<std::uint32_t>(text.length());
+		bs.Write(text.c_str(), text.length());
+		net::Multicast{ &bs, net::raknet::RPC_ClientMessage, net::message_class::chat }
+			.Patch(0, sizeof(std::uint32_t), [&colors](std::uint16_t playerid) { return colors[playerid]; })
+			.Send(recipients);
+
+		for (std::uint16_t id = 0; id < recipients.size(); ++id)
 		{
-			player->Chat()->Send(Darken(color, alpha), text);
+			if (!recipients.test(id))
+				continue;
+
+			auto* player = server::player_pool.Get(id);
+			if (player && player->Chat()->_register_messages)
+			{
+				player->Chat()->PushMessage(colors[id], text);
+			}
 		}
+	}
+}
 
-#undef RGBToHex
-#undef Darken
+bool CChat::FilterText(std::string& text)
+{
+	if (auto* blocked = chat::filter.Apply(text))
+	{
+		Send(0xED2B2BFF, "[ERROR] {{DADADA}}Tu mensaje no se ha enviado porque contiene {{ED2B2B}}{}{{DADADA}}.", blocked->description);
+		return false;
 	}
+
+	return true;
 }
 
-void CChat::SendPlayerMessage(const std::string& text)
+void CChat::SendPlayerMessage(std::string text)
 {
+	if (!FilterText(text))
+		return;
+
 	std::string final_msg = fmt::format("{{{:X}}}{}{{FFFFFF}}", static_cast<uint32_t>(GetPlayerColor(_player->PlayerId())) >> 8, _player->Name());
 	if (GetPlayerDrunkLevel(_player->PlayerId()) > 2000)
 		final_msg += " alcoholizado dice: ";
@@ -153,8 +178,11 @@ void CChat::SendPlayerMessage(const std::string& text)
 	SetPlayerChatBubble(*_player, chatbubble.c_str(), 0xFFFFFFFF, 15.f, 5000);
 }
 
-void CChat::SendAction(const std::string& action)
+void CChat::SendAction(std::string action)
 {
+	if (!FilterText(action))
+		return;
+
 	std::string message_start = fmt::format("* {} ", _player->Name());
 	auto messages = SplitChatMessage(action, 128 - message_start.length());
 	messages[0].insert(0, message_start);
@@ -170,8 +198,11 @@ void CChat::SendAction(const std::string& action)
 	SetPlayerChatBubble(*_player, chatbubble.c_str(), 0xC157EBFF, 15.f, 5000);
 }
 
-void CChat::SendEnvironment(const std::string& env)
+void CChat::SendEnvironment(std::string env)
 {
+	if (!FilterText(env))
+		return;
+
 	auto messages = SplitChatMessage(env, 122 - _player->Name().length());
 	messages.back() += fmt::format(" (( {} ))", _player->Name());
 	SendRangedMessage(0x46C759FF, 15.f, messages);
@@ -186,8 +217,11 @@ void CChat::SendEnvironment(const std::string& env)
 	SetPlayerChatBubble(*_player, chatbubble.c_str(), 0x46C759FF, 15.f, 5000);
 }
 
-void CChat::SendOOC(const std::string& text)
+void CChat::SendOOC(std::string text)
 {
+	if (!FilterText(text))
+		return;
+
 	std::string final_msg = fmt::format("{{{:X}}}{}{{FFFFFF}}: (( ", static_cast<std::uint32_t>(GetPlayerColor(_player->PlayerId())) >> 8, _player->Name());
 
 	auto max_length = 128 - final_msg.length() - 3;
@@ -223,7 +257,8 @@ cell chat::OnPlayerText(std::uint16_t playerid, std::string text)
 	}
 
 	std::replace(text.begin(), text.end(), '%', '#');
-	player->Chat()->SendPlayerMessage(text);
+	server::journal::writer.Record(server::journal::record_type::chat, player, text);
+	player->Chat()->SendPlayerMessage(std::move(text));
 
 	return 0;
 }
@@ -280,3 +315,73 @@ static command ooc_cmd("ooc"sv, { "b"sv }, [](CPlayer* player, commands::argumen
 
 	player->Chat()->SendOOC(text);
 });
+
+static command chatbench_cmd("chatbench", command::make_flag<player::rank::admin>, [](CPlayer* player, commands::argument_store args) {
+	int logins{ 50 };
+
+	try
+	{
+		if (!args.empty())
+			args >> logins;
+	}
+	catch (const std::exception& e)
+	{
+		player->Chat()->Send(0xDADADAFF, "USO: {ED2B2B}/chatbench{DADADA} [inicios de sesin]");
+		return;
+	}
+
+	logins = std::clamp(logins, 1, static_cast<int>(MAX_PLAYERS));
+
+	struct result
+	{
+		std::size_t queued;
+		std::size_t sent;
+		std::chrono::microseconds time;
+	};
+
+	// Everything goes to a queue of the benchmark's own that is drained instead of flushed, nothing reaches the
+	// client and the real queue isn't touched
+	const auto playerid = player->PlayerId();
+	auto measure = [](const std::function<void(net::CRpcQueue&)>& flow) -> result {
+		auto queue = std::make_unique<net::CRpcQueue>();
+		const auto start = std::chrono::steady_clock::now();
+
+		flow(*queue);
+
+		const auto time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+		const auto queued = queue->QueuedCount();
+		queue->Drain();
+		return { queued, queue->SentCount(), time };
+	};
+
+	// What Clear used to do: one queued RPC and one stored line per buffered message
+	const auto legacy = measure([&](net::CRpcQueue& queue) {
+		for (int i = 0; i < logins; ++i)
+		{
+			std::deque<std::pair<std::uint32_t, std::string>> buffer;
+
+			net::OutStream bs;
+			bs.Write<uint32_t>(0);
+			bs.Write<uint32_t>(1);
+			bs.Write(" ", 1);
+
+			for (std::size_t line = 0; line < CChat::chatbuffer_size; ++line)
+			{
+				queue.Push(&bs, net::raknet::RPC_ClientMessage, playerid, net::message_class::chat);
+				buffer.emplace_back(0, " ");
+			}
+		}
+	});
+
+	const auto bulk = measure([&](net::CRpcQueue& queue) {
+		for (int i = 0; i < logins; ++i)
+		{
+			CChat chat{ player };
+			chat.Clear(queue);
+		}
+	});
+
+	player->Chat()->Send(0xDADADAFF, "{} inicios de sesin:", logins);
+	player->Chat()->Send(0xDADADAFF, "Antes: {{ED2B2B}}{}{{DADADA}} RPCs en cola, {} enviados, {{ED2B2B}}{}{{DADADA}} us.", legacy.queued, legacy.sent, legacy.time.count());
+	player->Chat()->Send(0xDADADAFF, "Ahora: {{ED2B2B}}{}{{DADADA}} RPCs en cola, {} enviados, {{ED2B2B}}{}{{DADADA}} us.", bulk.queued, bulk.sent, bulk.time.count());
+});
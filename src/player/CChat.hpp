@@ -9,23 +9,21 @@ class CChat
 {
 	friend cell chat::OnPlayerText(std::uint16_t playerid, std::string text);
 
-	struct chat_message
-	{
-		std::uint32_t color;
-		std::string message;
-	};
-
 	CPlayer* _player;
-	std::deque<chat_message> _chatbuffer;
+	CChatHistory _history;
 	bool _register_messages{ false };
 
 	std::chrono::steady_clock::time_point _last_message;
 
-	void PushMessage(std::uint32_t color, const std::string& message);
+	void PushMessage(std::uint32_t color, std::string_view message);
+	void SendBlankLines(std::size_t count, net::CRpcQueue& queue = net::rpc_queue);
+	// Masks what the chat filter masks, false if the message must not be sent at all
+	bool FilterText(std::string& text);
 	std::vector<std::string> SplitChatMessage(const std::string& text, std::uint8_t max_line_length);
 
 public:
-	constexpr static std::size_t chatbuffer_size = 200U;
+	constexpr static std::size_t chatbuffer_size = CChatHistory::MAX_RECORDS;
+	constexpr static std::size_t client_chat_lines = 100U; // What the client keeps, scrolling back included
 	constexpr static auto message_cooldown = std::chrono::milliseconds{ 500 };
 
 	explicit CChat(CPlayer* player) : _player(player), _last_message(std::chrono::steady_clock::now())
@@ -41,26 +39,27 @@ public:
 	{
 		std::string formatted = fmt::format(message, std::forward<Args>(args)...);
 
-		BitStream bs;
+		net::OutStream bs;
 		bs.Write<std::uint32_t>(color);
 		bs.Write<std::uint32_t>(formatted.length());
 		bs.Write(formatted.c_str(), formatted.length());
-		net::RakServer->SendRPC(&bs, net::raknet::RPC_ClientMessage, _player->PlayerId());
+		net::rpc_queue.Push(&bs, net::raknet::RPC_ClientMessage, _player->PlayerId(), net::message_class::chat);
 
 		if (_register_messages)
 		{
-			PushMessage(color, std::move(formatted));
+			PushMessage(color, formatted);
 		}
 	}
 
 	void Resend();
 	void Flush();
-	void Clear();
+	// Only /chatbench passes a queue of its own
+	void Clear(net::CRpcQueue& queue = net::rpc_queue);
 
 	void SendRangedMessage(std::uint32_t color, float range, const std::string& text);
 	void SendRangedMessage(std::uint32_t color, float range, const std::vector<std::string>& messages);
-	void SendPlayerMessage(const std::string& text);
-	void SendAction(const std::string& action);
-	void SendEnvironment(const std::string& env);
-	void SendOOC(const std::string& text);
+	void SendPlayerMessage(std::string text);
+	void SendAction(std::string action);
+	void SendEnvironment(std::string env);
+	void SendOOC(std::string text);
 };
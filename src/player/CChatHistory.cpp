@@ -0,0 +1,56 @@
+#include "../main.hpp"
+
+void CChatHistory::PopFront()
+{
+	_first = (_first + 1) % MAX_RECORDS;
+	--_count;
+}
+
+void CChatHistory::Push(std::uint32_t color, std::string_view message)
+{
+	message = message.substr(0, MAX_MESSAGE_LENGTH);
+	const std::size_t size = sizeof(stRecordHeader) + message.length();
+
+	if (_count == MAX_RECORDS)
+		PopFront();
+
+	if (_count == 0u)
+	{
+		_first = 0u;
+		_write = 0u;
+	}
+	else if (_write + size > ARENA_SIZE)
+	{
+		// Records never straddle the end of the arena, whatever is left there goes unused until the next lap.
+		// Anything already past the write position is older than everything at the start, it goes first.
+		while (_count && _offsets[_first] >= _write)
+			PopFront();
+
+		_write = 0u;
+	}
+
+	// Records are laid out oldest to newest starting right after the write position, so only the oldest one
+	// can be in the way
+	while (_count)
+	{
+		const auto oldest = _offsets[_first];
+		if (oldest >= _write + size || oldest + RecordSize(oldest) <= _write)
+			break;
+
+		PopFront();
+	}
+
+	const stRecordHeader header{ color, static_cast<std::uint8_t>(message.length()) };
+	std::memcpy(&_arena[_write], &header, sizeof(header));
+	std::memcpy(&_arena[_write + sizeof(header)], message.data(), message.length());
+
+	_offsets[(_first + _count) % MAX_RECORDS] = static_cast<std::uint16_t>(_write);
+	++_count;
+	_write += size;
+}
+
+void CChatHistory::Clear()
+{
+	_first = _count = _write = 0u;
+	_cleared = false;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+// Last chat lines a player received, kept so they can be sent again. Every line is a record (colour, length
+// and text) written one after another into a fixed arena that wraps around, the oldest records are dropped
+// to make room. Pushing never allocates and memory is bounded by ARENA_SIZE.
+class CChatHistory
+{
+public:
+	static constexpr std::size_t MAX_RECORDS = 200;
+	static constexpr std::size_t MAX_MESSAGE_LENGTH = 144; // What the client shows, longer lines are cut
+	static constexpr std::size_t ARENA_SIZE = 16 * 1024;
+
+private:
+#pragma pack(push, 1)
+	struct stRecordHeader
+	{
+		std::uint32_t color;
+		std::uint8_t length;
+	};
+#pragma pack(pop)
+
+	std::array<unsigned char, ARENA_SIZE> _arena;
+	std::array<std::uint16_t, MAX_RECORDS> _offsets; // Where each record starts, oldest at _first
+	std::size_t _first{ 0u };
+	std::size_t _count{ 0u };
+	std::size_t _write{ 0u }; // Where the next record goes
+	bool _cleared{ false }; // The chat was wiped before the oldest record, instead of storing the blank lines
+
+	inline std::size_t RecordSize(std::size_t offset) const { return sizeof(stRecordHeader) + _arena[offset + offsetof(stRecordHeader, length)]; }
+	void PopFront();
+
+public:
+	void Push(std::uint32_t color, std::string_view message);
+	// Forgets every record
+	void Clear();
+	// Forgets every record and remembers that the client's chat was wiped too
+	inline void MarkCleared() { Clear(); _cleared = true; }
+
+	inline bool Cleared() const { return _cleared; }
+	inline std::size_t Size() const { return _count; }
+	inline bool Empty() const { return _count == 0u; }
+
+	// Calls `fn(color, text)` for every record, oldest first. The text points into the arena.
+	template<class F>
+	void ForEach(F&& fn) const
+	{
+		for (std::size_t i = 0; i < _count; ++i)
+		{
+			const auto offset = _offsets[(_first + i) % MAX_RECORDS];
+
+			stRecordHeader header;
+			std::memcpy(&header, &_arena[offset], sizeof(header));
+			fn(header.color, std::string_view{ reinterpret_cast<const char*>(&_arena[offset + sizeof(header)]), header.length });
+		}
+	}
+};
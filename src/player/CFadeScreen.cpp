@@ -12,7 +12,8 @@ CFadeScreen::CFadeScreen(std::uint16_t playerid)
 		->SetLetterColor(-1)
 		->SetBackgroundColor(255)
 		->SetBoxColor(195)
-		->ToggleBox(true);
+		->ToggleBox(true)
+		->ToggleAnimated(true);
 }
 
 CFadeScreen::~CFadeScreen()
@@ -30,7 +31,7 @@ void CFadeScreen::Fade(unsigned char callback_alpha, std::function<void()> callb
 	}
 
 	_in = true;
-	_textdraw->SetBoxColor(0);
+	_textdraw->AsFrame(false)->SetBoxColor(0);
 	_textdraw->Show();
 
 	_timer = timers::timer_manager->Repeat(20, 20, [callback,callback_alpha,this](timers::CTimer* timer) {
@@ -49,7 +50,9 @@ void CFadeScreen::Fade(unsigned char callback_alpha, std::function<void()> callb
 			return;
 		}
 
-		_textdraw->SetBoxColor((_in ? alpha + 5 : alpha - 5));
+		// Only fully transparent and fully opaque steps have to make it to the client
+		std::uint8_t next = (_in ? alpha + 5 : alpha - 5);
+		_textdraw->AsFrame(next != 0 && next != 255)->SetBoxColor(next);
 	});
 }
 
@@ -65,7 +68,7 @@ void CFadeScreen::Fade(unsigned char callback_alpha, bool in, std::function<void
 	}
 
 	_in = in;
-	_textdraw->SetBoxColor((_in ? 0 : 0xFF));
+	_textdraw->AsFrame(false)->SetBoxColor((_in ? 0 : 0xFF));
 	_textdraw->Show();
 
 	_timer = timers::timer_manager->Repeat(20, 20, [callback, callback_alpha, this](timers::CTimer* timer) {
@@ -84,7 +87,9 @@ void CFadeScreen::Fade(unsigned char callback_alpha, bool in, std::function<void
 			return;
 		}
 
-		_textdraw->SetBoxColor((_in ? alpha + 5 : alpha - 5));
+		// Only fully transparent and fully opaque steps have to make it to the client
+		std::uint8_t next = (_in ? alpha + 5 : alpha - 5);
+		_textdraw->AsFrame(next != 0 && next != 255)->SetBoxColor(next);
 	});
 }
 
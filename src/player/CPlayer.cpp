@@ -8,6 +8,7 @@ CPlayer::CPlayer(std::uint16_t playerid)
 		_chat(std::make_unique<CChat>(this)),
 		_keygame(std::make_unique<CKeyGame>(this)),
 		_vehicles(std::make_unique<CPlayerVehicleManager>(this)),
+		_td_indexer(playerid),
 		_last_command(std::chrono::steady_clock::now())
 {
 	_ip_address.resize(16);
@@ -56,7 +57,7 @@ void CPlayer::ToggleWidescreen()
 {
 	_widescreen = !_widescreen;
 
-	BitStream bs;
+	net::OutStream bs;
 	bs.Write<bool>(_widescreen);
 	net::RakServer->SendRPC(&bs, net::raknet::RPC_Widescreen, _playerid);
 }
@@ -64,7 +65,7 @@ void CPlayer::ToggleWidescreen()
 void CPlayer::ToggleWidescreen(bool set)
 {
 	_widescreen = set;
-	BitStream bs;
+	net::OutStream bs;
 	bs.Write<bool>(_widescreen);
 	net::RakServer->SendRPC(&bs, net::raknet::RPC_Widescreen, _playerid);
 }
@@ -127,16 +128,17 @@ void CPlayer::StopShopping()
 
 void CPlayer::PutInVehicle(CVehicle* vehicle, std::uint8_t seat)
 {
-	if (IsPlayerInAnyVehicle(_playerid))
+	if (vehicles::occupancy.VehicleOf(_playerid) != INVALID_VEHICLE_ID)
 		RemovePlayerFromVehicle(_playerid);
 
-	PutPlayerInVehicle(_playerid, vehicle->ID(), seat);
+	if (PutPlayerInVehicle(_playerid, vehicle->ID(), seat))
+		vehicles::occupancy.Enter(_playerid, vehicle->ID(), seat);
 }
 
 CVehicle* CPlayer::GetCurrentVehicle() const
 {
-	std::uint16_t id = GetPlayerVehicleID(_playerid);
-	if (!id || id == INVALID_VEHICLE_ID)
+	std::uint16_t id = vehicles::occupancy.VehicleOf(_playerid);
+	if (id == INVALID_VEHICLE_ID)
 		return nullptr;
 
 	return vehicles::vehicle_pool[id].get();
@@ -62,7 +62,7 @@ private:
 	std::unique_ptr<CChat> _chat;
 	std::unique_ptr<CKeyGame> _keygame;
 	std::unique_ptr<CPlayerVehicleManager> _vehicles;
-	server::TextDrawIndexManager _td_indexer{};
+	server::TextDrawIndexManager _td_indexer;
 	
 	std::string _ip_address;
 	std::string _name;
@@ -3,7 +3,6 @@
 CSpeedometer::CSpeedometer(CPlayer* player)
 	: _player(player)
 {
-	textdraw_manager.LoadFile("speedometer.toml", "speedometer");
 }
 
 CSpeedometer::~CSpeedometer()
@@ -0,0 +1,440 @@
+#include "../main.hpp"
+
+chat::CChatFilter chat::filter{};
+
+// The list is UTF-8 like every other TOML file, the client speaks Latin-1
+static std::string FilterUtf8ToLatin1(std::string_view text)
+{
+	std::string result;
+	result.reserve(text.length());
+
+	for (std::size_t i = 0; i < text.length(); ++i)
+	{
+		const auto c = static_cast<unsigned char>(text[i]);
+		if (c < 0x80)
+		{
+			result += static_cast<char>(c);
+		}
+		else if ((c == 0xC2 || c == 0xC3) && i + 1 < text.length())
+		{
+			result += static_cast<char>(((c & 0x03) << 6) | (static_cast<unsigned char>(text[++i]) & 0x3F));
+		}
+		else if (c >= 0xC0)
+		{
+			// Nothing the client can show, skip the whole sequence
+			result += '?';
+			while (i + 1 < text.length() && (static_cast<unsigned char>(text[i + 1]) & 0xC0) == 0x80)
+				++i;
+		}
+	}
+
+	return result;
+}
+
+chat::CPatternMatcher::CPatternMatcher(std::span<const std::string> patterns)
+{
+	// Columns first, every state needs a full row
+	for (auto&& pattern : patterns)
+	{
+		for (unsigned char c : pattern)
+		{
+			const auto folded = Latin1FoldLUT[c];
+			if (!_columns_of[folded])
+				_columns_of[folded] = static_cast<std::uint8_t>(_columns++);
+		}
+	}
+
+	_transitions.assign(_columns, 0u);
+	_pattern.assign(1u, NO_PATTERN);
+	_lengths.reserve(patterns.size());
+
+	// Trie. The root is state 0 and never anyone's child, so 0 means "no edge" until the failure links are in
+	for (std::uint32_t id = 0; id < patterns.size(); ++id)
+	{
+		const auto& pattern = patterns[id];
+		_lengths.push_back(static_cast<std::uint16_t>(pattern.length()));
+		if (pattern.empty())
+			continue;
+
+		std::uint32_t state = 0u;
+		for (unsigned char c : pattern)
+		{
+			auto& next = _transitions[state * _columns + _columns_of[Latin1FoldLUT[c]]];
+			if (!next)
+			{
+				next = static_cast<std::uint32_t>(_pattern.size());
+				_pattern.push_back(NO_PATTERN);
+				_transitions.resize(_transitions.size() + _columns, 0u);
+			}
+
+			// `next` may dangle after the resize
+			state = _transitions[state * _columns + _columns_of[Latin1FoldLUT[c]]];
+		}
+
+		// Duplicates keep the first pattern
+		if (_pattern[state] == NO_PATTERN)
+			_pattern[state] = id;
+	}
+
+	// Breadth first, so the failure state of every state has its row complete by the time it's needed
+	std::vector<std::uint32_t> failure(_pattern.size(), 0u);
+	_output_link.assign(_pattern.size(), 0u);
+
+	std::queue<std::uint32_t> pending;
+	pending.push(0u);
+	while (!pending.empty())
+	{
+		const auto state = pending.front();
+		pending.pop();
+
+		for (std::uint32_t column = 0; column < _columns; ++column)
+		{
+			auto& next = _transitions[state * _columns + column];
+			const auto fallback = (state ? _transitions[failure[state] * _columns + column] : 0u);
+
+			if (next)
+			{
+				failure[next] = fallback;
+				_output_link[next] = (_pattern[fallback] != NO_PATTERN ? fallback : _output_link[fallback]);
+				pending.push(next);
+			}
+			else
+			{
+				next = fallback;
+			}
+		}
+	}
+}
+
+void chat::CChatFilter::FindIpAddresses(std::string_view text, std::uint16_t category_index, std::vector<filter_match>& matches)
+{
+	// Four groups of one to three digits separated by dots, with an optional port
+	for (std::size_t i = 0; i < text.length(); ++i)
+	{
+		if (!std::isdigit(static_cast<unsigned char>(text[i])) || (i && std::isdigit(static_cast<unsigned char>(text[i - 1]))))
+			continue;
+
+		std::size_t end = i;
+		int groups = 0;
+		while (groups < 4)
+		{
+			std::size_t digits = 0;
+			while (end < text.length() && digits < 4 && std::isdigit(static_cast<unsigned char>(text[end])))
+			{
+				++end;
+				++digits;
+			}
+
+			if (!digits || digits > 3)
+				break;
+
+			++groups;
+			if (groups < 4)
+			{
+				if (end >= text.length() || text[end] != '.')
+					break;
+				++end;
+			}
+		}
+
+		if (groups != 4)
+			continue;
+
+		if (end + 1 < text.length() && text[end] == ':' && std::isdigit(static_cast<unsigned char>(text[end + 1])))
+		{
+			++end;
+			while (end < text.length() && std::isdigit(static_cast<unsigned char>(text[end])))
+				++end;
+		}
+
+		matches.push_back({ i, end, category_index });
+		i = end - 1;
+	}
+}
+
+bool chat::CChatFilter::Load(const std::filesystem::path& path)
+{
+	_path = path;
+
+	toml::table tbl;
+	try
+	{
+		tbl = toml::parse_file(path.string());
+	}
+	catch (const toml::parse_error& e)
+	{
+		sampgdk::logprintf("[chat:filter] Failed to parse %s: %s", path.string().c_str(), e.what());
+		return false;
+	}
+
+	std::vector<category> categories;
+	std::vector<std::string> patterns;
+	std::vector<std::uint16_t> pattern_category;
+	// A pattern listed in several categories belongs to the first one that blocks it, or else to the first one
+	robin_hood::unordered_map<std::string, std::size_t> seen;
+	bool ip_addresses = false;
+
+	for (auto&& [key, node] : tbl)
+	{
+		auto* table = node.as_table();
+		if (!table)
+			continue;
+
+		const auto index = static_cast<std::uint16_t>(categories.size());
+		auto& added = categories.emplace_back();
+		added.name = std::string{ key.str() };
+		added.description = FilterUtf8ToLatin1((*table)["description"].value_or<std::string>(added.name));
+		added.action = ((*table)["action"].value_or<std::string>("mask") == "block" ? filter_action::block : filter_action::mask);
+		added.whole_words = (*table)["whole_words"].value_or<bool>(false);
+		added.ip_addresses = (*table)["ip_addresses"].value_or<bool>(false);
+		ip_addresses |= added.ip_addresses;
+
+		auto* list = (*table)["patterns"].as_array();
+		if (!list)
+			continue;
+
+		for (auto&& pattern_node : *list)
+		{
+			auto pattern = FilterUtf8ToLatin1(pattern_node.value_or<std::string>(""));
+			if (pattern.empty() || pattern.length() > std::numeric_limits<std::uint8_t>::max())
+				continue;
+
+			std::transform(pattern.begin(), pattern.end(), pattern.begin(), [](char c) { return static_cast<char>(Latin1FoldLUT[static_cast<unsigned char>(c)]); });
+
+			auto [it, inserted] = seen.emplace(pattern, patterns.size());
+			if (inserted)
+			{
+				patterns.push_back(std::move(pattern));
+				pattern_category.push_back(index);
+				++added.patterns;
+			}
+			else if (added.action == filter_action::block && categories[pattern_category[it->second]].action != filter_action::block)
+			{
+				--categories[pattern_category[it->second]].patterns;
+				pattern_category[it->second] = index;
+				++added.patterns;
+			}
+		}
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	auto matcher = std::make_unique<CPatternMatcher>(patterns);
+	const auto build_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+	_categories = std::move(categories);
+	_pattern_category = std::move(pattern_category);
+	_matcher = std::move(matcher);
+	_ip_addresses = ip_addresses;
+
+	sampgdk::logprintf("[chat:filter] Loaded %u patterns in %u categories (%u states, %u KB, built in %u us).", patterns.size(), _categories.size(), _matcher->States(), _matcher->MemoryUsage() / 1024, build_time.count());
+	return true;
+}
+
+bool chat::CChatFilter::Watch()
+{
+	if (_poll)
+		return true;
+
+	_poll = new uv_fs_poll_t;
+	uv_fs_poll_init(uv_default_loop(), _poll);
+	_poll->data = this;
+
+	auto on_change = [](uv_fs_poll_t* handle, int status, const uv_stat_t* /*prev*/, const uv_stat_t* /*curr*/) {
+		if (status < 0)
+			return;
+
+		auto* filter = static_cast<CChatFilter*>(handle->data);
+		if (filter->Reload())
+			sampgdk::logprintf("[chat:filter] Reloaded %s after it changed on disk.", filter->_path.string().c_str());
+	};
+
+	if (int err = uv_fs_poll_start(_poll, on_change, _path.string().c_str(), POLL_INTERVAL); err < 0)
+	{
+		sampgdk::logprintf("[chat:filter] Couldn't watch %s: %s", _path.string().c_str(), uv_strerror(err));
+		uv_close(reinterpret_cast<uv_handle_t*>(_poll), [](uv_handle_t* handle) {
+			delete reinterpret_cast<uv_fs_poll_t*>(handle);
+		});
+		_poll = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+std::vector<chat::filter_match> chat::CChatFilter::Find(std::string_view text) const
+{
+	std::vector<filter_match> matches;
+	if (!_matcher)
+		return matches;
+
+	_matcher->Scan(text, [&](std::uint32_t pattern, std::size_t begin, std::size_t end) {
+		const auto category_index = _pattern_category[pattern];
+		if (_categories[category_index].whole_words)
+		{
+			if ((begin && IsWordCharacter(text[begin - 1])) || (end < text.length() && IsWordCharacter(text[end])))
+				return;
+		}
+
+		matches.push_back({ begin, end, category_index });
+	});
+
+	if (_ip_addresses)
+	{
+		for (std::uint16_t i = 0; i < _categories.size(); ++i)
+		{
+			if (_categories[i].ip_addresses)
+				FindIpAddresses(text, i, matches);
+		}
+	}
+
+	std::sort(matches.begin(), matches.end(), [](const filter_match& a, const filter_match& b) { return a.begin < b.begin; });
+	return matches;
+}
+
+const chat::CChatFilter::category* chat::CChatFilter::Apply(std::string& text)
+{
+	auto matches = Find(text);
+	const category* blocked = nullptr;
+
+	for (auto&& match : matches)
+	{
+		auto& matched = _categories[match.category];
+		++matched.hits;
+
+		if (matched.action == filter_action::block)
+		{
+			if (!blocked)
+				blocked = &matched;
+		}
+		else
+		{
+			std::fill(text.begin() + match.begin, text.begin() + match.end, '*');
+		}
+	}
+
+	return blocked;
+}
+
+static public_hook _cf_ogmi("OnGameModeInit", +[]() -> cell {
+	if (chat::filter.Load(std::filesystem::current_path() / "scriptfiles" / "chat_filter.toml"))
+		chat::filter.Watch();
+
+	return 1;
+});
+
+static command chatfilter_cmd("chatfilter", command::make_flag<player::rank::admin>, [](CPlayer* player, cmd::argument_store args) {
+	std::string action;
+
+	try
+	{
+		args >> action;
+	}
+	catch (const std::exception& e)
+	{
+		player->Chat()->Send(0xDADADAFF, "USO: {ED2B2B}/chatfilter{DADADA} <reload/status/bench>");
+		return;
+	}
+
+	if (action == "reload")
+	{
+		if (!chat::filter.Reload())
+		{
+			player->Chat()->Send(0xED2B2BFF, "[ERROR] {DADADA}No se pudo leer la lista de filtros, se mantiene la anterior.");
+			return;
+		}
+
+		player->Chat()->Send(0xDADADAFF, "Filtro de chat recargado.");
+	}
+	else if (action == "status")
+	{
+		for (auto&& category : chat::filter.Categories())
+		{
+			player->Chat()->Send(0xDADADAFF, "{{ED2B2B}}{}{{DADADA}}: {} patrones, {}, {} coincidencias.", category.name, category.patterns, (category.action == chat::filter_action::block ? "bloquea" : "censura"), category.hits);
+		}
+
+		if (auto* matcher = chat::filter.Matcher())
+			player->Chat()->Send(0xDADADAFF, "Autmata: {{ED2B2B}}{}{{DADADA}} estados, {{ED2B2B}}{}{{DADADA}} KB.", matcher->States(), matcher->MemoryUsage() / 1024);
+	}
+	else if (action == "bench")
+	{
+		int iterations{ 1000 };
+
+		try
+		{
+			if (!args.empty())
+				args >> iterations;
+		}
+		catch (const std::exception& e)
+		{
+			player->Chat()->Send(0xDADADAFF, "USO: {ED2B2B}/chatfilter bench{DADADA} [iteraciones]");
+			return;
+		}
+
+		iterations = std::clamp(iterations, 1, 100000);
+
+		// 5000 made up words of 4 to 10 letters, the size of a real list, always the same ones
+		constexpr std::size_t PATTERN_COUNT = 5000;
+		std::mt19937 generator{ 1337u };
+		std::vector<std::string> patterns;
+		patterns.reserve(PATTERN_COUNT);
+		for (std::size_t i = 0; i < PATTERN_COUNT; ++i)
+		{
+			std::string pattern(4 + generator() % 7, ' ');
+			for (auto&& c : pattern)
+				c = static_cast<char>('a' + generator() % 26);
+			patterns.push_back(std::move(pattern));
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		const chat::CPatternMatcher matcher{ patterns };
+		const auto build_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+		// Typical messages, padded to the 128 characters the client allows
+		std::vector<std::string> messages = {
+			"Hola a todos, alguien sabe dnde puedo encontrar un mecnico cerca del ayuntamiento? Se me ha roto el coche en medio de la calle",
+			"Vendo Sultan en perfecto estado, full tuning y con los papeles en regla. Precio negociable, interesados mandadme un mensaje privado",
+			"* Juan_Garcia saca su telfono del bolsillo, marca el nmero de la polica y espera a que alguien conteste al otro lado de la lnea."
+		};
+		for (auto&& message : messages)
+			message.resize(128, ' ');
+
+		std::size_t found = 0u;
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; ++i)
+		{
+			for (auto&& message : messages)
+				matcher.Scan(message, [&found](std::uint32_t, std::size_t, std::size_t) { ++found; });
+		}
+		const auto automaton_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+		// What a find loop over the list would cost, on the same folded text
+		const int naive_iterations = std::max(1, iterations / 100);
+		std::size_t naive_found = 0u;
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < naive_iterations; ++i)
+		{
+			for (auto&& message : messages)
+			{
+				std::string folded{ message };
+				std::transform(folded.begin(), folded.end(), folded.begin(), [](char c) { return static_cast<char>(chat::Latin1FoldLUT[static_cast<unsigned char>(c)]); });
+
+				for (auto&& pattern : patterns)
+				{
+					for (auto pos = folded.find(pattern); pos != std::string::npos; pos = folded.find(pattern, pos + 1))
+						++naive_found;
+				}
+			}
+		}
+		const auto naive_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+		const auto scans = static_cast<double>(iterations) * messages.size();
+		const auto naive_scans = static_cast<double>(naive_iterations) * messages.size();
+		player->Chat()->Send(0xDADADAFF, "{} patrones: autmata de {{ED2B2B}}{}{{DADADA}} estados ({} KB) construido en {{ED2B2B}}{}{{DADADA}} us.", PATTERN_COUNT, matcher.States(), matcher.MemoryUsage() / 1024, build_time.count());
+		player->Chat()->Send(0xDADADAFF, "Aho-Corasick: {{ED2B2B}}{:.0f}{{DADADA}} ns por mensaje de 128 caracteres ({} coincidencias).", automaton_time.count() / scans, found / iterations);
+		player->Chat()->Send(0xDADADAFF, "Bsqueda uno a uno: {{ED2B2B}}{:.0f}{{DADADA}} ns por mensaje ({} coincidencias).", naive_time.count() / naive_scans, naive_found / naive_iterations);
+	}
+	else
+	{
+		player->Chat()->Send(0xDADADAFF, "USO: {ED2B2B}/chatfilter{DADADA} <reload/status/bench>");
+	}
+});
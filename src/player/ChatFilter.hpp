@@ -0,0 +1,121 @@
+#pragma once
+
+namespace chat
+{
+	// Case folding for the Latin-1 the client sends: A-Z and the accented capitals map to lowercase
+	constexpr auto Latin1FoldLUT = [] {
+		std::array<std::uint8_t, 256> lut{};
+		for (std::size_t c = 0; c < lut.size(); ++c)
+		{
+			const bool upper = (c >= 'A' && c <= 'Z') || (c >= 0xC0 && c <= 0xDE && c != 0xD7);
+			lut[c] = static_cast<std::uint8_t>(upper ? c + 0x20 : c);
+		}
+		return lut;
+	}();
+
+	inline bool IsWordCharacter(unsigned char c)
+	{
+		return std::isalnum(c) || (c >= 0xC0 && c != 0xD7 && c != 0xF7);
+	}
+
+	// Aho-Corasick automaton over the case folded patterns, compiled to a DFA so scanning costs one table
+	// lookup per character no matter how many patterns there are. Only the bytes that appear in some pattern
+	// get a column of their own, everything else shares column 0.
+	class CPatternMatcher
+	{
+		static constexpr std::uint32_t NO_PATTERN = 0xFFFFFFFF;
+
+		std::array<std::uint8_t, 256> _columns_of{};
+		std::uint32_t _columns{ 1u };
+		std::vector<std::uint32_t> _transitions; // States x columns
+		std::vector<std::uint32_t> _pattern; // Longest pattern that ends in each state
+		std::vector<std::uint32_t> _output_link; // Closest state on the failure chain that ends a pattern, 0 for none
+		std::vector<std::uint16_t> _lengths;
+
+	public:
+		// Empty patterns never match
+		explicit CPatternMatcher(std::span<const std::string> patterns);
+
+		// Calls `fn(pattern, begin, end)` for every occurrence of every pattern, overlapping ones included
+		template<class F>
+		void Scan(std::string_view text, F&& fn) const
+		{
+			std::uint32_t state = 0u;
+			for (std::size_t i = 0; i < text.length(); ++i)
+			{
+				const auto c = Latin1FoldLUT[static_cast<unsigned char>(text[i])];
+				state = _transitions[state * _columns + _columns_of[c]];
+
+				for (auto match = (_pattern[state] != NO_PATTERN ? state : _output_link[state]); match; match = _output_link[match])
+				{
+					const auto pattern = _pattern[match];
+					fn(pattern, i + 1 - _lengths[pattern], i + 1);
+				}
+			}
+		}
+
+		inline std::size_t States() const { return _pattern.size(); }
+		inline std::size_t MemoryUsage() const { return (_transitions.size() + _pattern.size() + _output_link.size()) * sizeof(std::uint32_t) + _lengths.size() * sizeof(std::uint16_t); }
+	};
+
+	enum class filter_action : std::uint8_t
+	{
+		mask, // Matches are replaced with asterisks
+		block // The message isn't sent at all
+	};
+
+	struct filter_match
+	{
+		std::size_t begin;
+		std::size_t end;
+		std::uint16_t category;
+	};
+
+	// Profanity, advertising and spam filter. Categories and their patterns are loaded from
+	// scriptfiles/chat_filter.toml and reloaded when the file changes.
+	class CChatFilter
+	{
+	public:
+		struct category
+		{
+			std::string name;
+			std::string description; // Shown to the player when a message is blocked
+			filter_action action{ filter_action::mask };
+			bool whole_words{ false };
+			bool ip_addresses{ false };
+			std::size_t patterns{ 0u };
+			std::size_t hits{ 0u };
+		};
+
+	private:
+		static constexpr unsigned POLL_INTERVAL = 2000;
+
+		std::filesystem::path _path;
+		std::vector<category> _categories;
+		std::vector<std::uint16_t> _pattern_category;
+		std::unique_ptr<CPatternMatcher> _matcher;
+		bool _ip_addresses{ false };
+		uv_fs_poll_t* _poll{ nullptr };
+
+		static void FindIpAddresses(std::string_view text, std::uint16_t category_index, std::vector<filter_match>& matches);
+
+	public:
+		CChatFilter() = default;
+		~CChatFilter() = default;
+
+		// Keeps the previous list if the file can't be parsed
+		bool Load(const std::filesystem::path& path);
+		bool Reload() { return Load(_path); }
+		bool Watch();
+
+		// Spans to filter, sorted by position. Whole word categories only match whole words.
+		std::vector<filter_match> Find(std::string_view text) const;
+		// Masks whatever has to be masked in place. Returns the category that blocks the message, if any
+		const category* Apply(std::string& text);
+
+		inline const std::vector<category>& Categories() const { return _categories; }
+		inline const CPatternMatcher* Matcher() const { return _matcher.get(); }
+	};
+
+	extern CChatFilter filter;
+}
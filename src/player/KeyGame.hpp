@@ -28,10 +28,7 @@ public:
 		{ "~k~~GO_FORWARD~", KEY_UP }
 	} };
 
-	explicit CKeyGame(CPlayer* player) : _player(player)
-	{
-		textdraw_manager.LoadFile("keygame.toml", "keygame");
-	}
+	explicit CKeyGame(CPlayer* player) : _player(player) {}
 
 	void Start(float key_percentage_up = 9.9F, float decrease_sec = 2.5F, std::function<void(CPlayer*, bool)> callback = nullptr);
 	void Stop();
@@ -54,26 +54,7 @@ void player::CNeedsManager::ShowBars()
 	_bars_shown = true;
 	UpdateTextDraws();
 	
-	auto* textdraws = textdraw_manager["needs"];
-	auto& global = textdraws->GetGlobalTextDraws();
-
-	global[0]->Show(_player);
-	global[1]->Show(_player);
-	global[2]->Show(_player);
-	global[3]->Show(_player);
-
-	textdraws->GetPlayerTextDraws(_player)[0]->Show();
-
-	global[4]->Show(_player);
-	global[5]->Show(_player);
-	global[6]->Show(_player);
-	global[7]->Show(_player);
-	global[8]->Show(_player);
-
-	textdraws->GetPlayerTextDraws(_player)[1]->Show();
-
-	for (std::uint8_t i = 9; i < textdraws->GetGlobalTextDraws().size(); ++i)
-		textdraws->GetGlobalTextDraws()[i]->Show(_player);
+	textdraw_manager["needs"]->Show(_player, "bars");
 }
 
 void player::CNeedsManager::HideBars()
@@ -28,9 +28,7 @@ namespace player
 	public:
 		explicit CNeedsManager(CPlayer* player)
 			: _player(player)
-		{
-			textdraw_manager.LoadFile("needs", "needs");
-		}
+		{}
 
 		void StartUpdating();
 		void StopUpdating();
@@ -22,11 +22,13 @@ void player::CNotificationManager::MoveRight(timers::CTimer* timer, CPlayer* pla
 
 	auto* textdraws = textdraw_manager[fmt::format("notification_{}", idx)];
 	auto& ptds = textdraws->GetPlayerTextDraws(player);
-	ptds[0]->SetPosition({ (108.f - NOT_SUB_VAL) + x, 290.f - (46.f * idx) });
-	ptds[1]->SetPosition({ (17.f - NOT_SUB_VAL) + x, 293.f - (46.f * idx) });
-	ptds[2]->SetPosition({ (20.50f - NOT_SUB_VAL) + x, 293.f - (46.f * idx) });
-	ptds[3]->SetPosition({ (29.60f - NOT_SUB_VAL) + x, 299.f - (46.f * idx) });
-	ptds[4]->SetPosition({ (48.f - NOT_SUB_VAL) + x, 299.f - (46.f * idx) });
+	// The frame that reaches the final position is sent reliably
+	const bool frame = (t < 1.0);
+	ptds[0]->AsFrame(frame)->SetPosition({ (108.f - NOT_SUB_VAL) + x, 290.f - (46.f * idx) });
+	ptds[1]->AsFrame(frame)->SetPosition({ (17.f - NOT_SUB_VAL) + x, 293.f - (46.f * idx) });
+	ptds[2]->AsFrame(frame)->SetPosition({ (20.50f - NOT_SUB_VAL) + x, 293.f - (46.f * idx) });
+	ptds[3]->AsFrame(frame)->SetPosition({ (29.60f - NOT_SUB_VAL) + x, 299.f - (46.f * idx) });
+	ptds[4]->AsFrame(frame)->SetPosition({ (48.f - NOT_SUB_VAL) + x, 299.f - (46.f * idx) });
 
 	if (t >= 1.0)
 	{
@@ -59,11 +61,12 @@ void player::CNotificationManager::MoveLeft(timers::CTimer* timer, CPlayer* play
 	}
 
 	auto& ptds = textdraws->GetPlayerTextDraws(player);
-	ptds[0]->SetPosition({ 108.f - x, 290.f - (46.f * idx) });
-	ptds[1]->SetPosition({ 17.f - x, 293.f - (46.f * idx) });
-	ptds[2]->SetPosition({ 20.50f - x, 293.f - (46.f * idx) });
-	ptds[3]->SetPosition({ 29.60f - x, 299.f - (46.f * idx) });
-	ptds[4]->SetPosition({ 50.f - x, 299.f - (46.f * idx) });
+	// The animation ends hiding the textdraws, which is always reliable
+	ptds[0]->AsFrame()->SetPosition({ 108.f - x, 290.f - (46.f * idx) });
+	ptds[1]->AsFrame()->SetPosition({ 17.f - x, 293.f - (46.f * idx) });
+	ptds[2]->AsFrame()->SetPosition({ 20.50f - x, 293.f - (46.f * idx) });
+	ptds[3]->AsFrame()->SetPosition({ 29.60f - x, 299.f - (46.f * idx) });
+	ptds[4]->AsFrame()->SetPosition({ 50.f - x, 299.f - (46.f * idx) });
 
 	while (!manager->_shown.all() && !manager->_pending.empty())
 	{
@@ -100,13 +103,14 @@ bool player::CNotificationManager::Show(const std::string& message, std::uint16_
 	for (size_t i = 0, j = message.length(); i < j; i += 45)
 		size -= 0.015f;
 
-	std::string split_message = message;
-	server::textdraw::SplitTextDrawString(split_message, 122.5f, size, 1, 1, true);
+	std::string split_message = server::textdraw::measure_cache.Wrap(message, 122.5f, size, 1, 1, true);
 
 	for (auto&& td : textdraws->GetPlayerTextDraws(_player))
 	{
 		auto pos = td->GetPosition();
-		td->SetPosition({ pos.first - NOT_SUB_VAL, pos.second + (46.f * idx) });
+		td->ToggleAnimated(true)
+			->AsFrame(false)
+			->SetPosition({ pos.first - NOT_SUB_VAL, pos.second + (46.f * idx) });
 	}
 
 	textdraws->GetPlayerTextDraws(_player)[4]
@@ -132,8 +136,10 @@ void player::CNotificationManager::ShowBeatingText(std::uint16_t time, std::uint
 	std::string fixed_str{ text };
 	std::replace(fixed_str.begin(), fixed_str.end(), ' ', '_');
 
-	auto* textdraw = textdraw_manager.LoadFile("beating_text.toml", "beating_text");
+	auto* textdraw = textdraw_manager["beating_text"];
 	textdraw->GetPlayerTextDraws(_player)[0]
+		->ToggleAnimated(true)
+		->AsFrame(false)
 		->SetText(fixed_str)
 		->SetLetterColor((color << 8) ^ alpha.second)
 		->SetBackgroundColor(alpha.second);
@@ -192,6 +198,7 @@ void player::CNotificationManager::ProcessBeatingText(timers::CTimer* timer, CPl
 	current_alpha = std::clamp<int16_t>(current_alpha, 0, 255);
 	color = (color & 0xFFFFFF00) | current_alpha;
 	textdraw
+		->AsFrame()
 		->SetLetterColor(color)
 		->SetBackgroundColor(current_alpha);
 
@@ -44,12 +44,7 @@ namespace player
 	public:
 		explicit CNotificationManager(CPlayer* player)
 			: _player(player)
-		{
-			for (size_t i = 0; i < MAX_NOTIFICATIONS; ++i)
-			{
-				textdraw_manager.LoadFile("notification", fmt::format("notification_{}", i));
-			}
-		}
+		{}
 
 		bool Show(const std::string& message, std::uint16_t time_ms);
 		void ShowBeatingText(std::uint16_t time, std::uint32_t color, std::pair<std::uint8_t, std::uint8_t> alpha, const std::string& text);
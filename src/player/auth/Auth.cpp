@@ -89,6 +89,7 @@ namespace auth
 
 					player->SetPosition({ 2109.1204, -1790.6901, 13.5547, 350.1182 });
 					SetPlayerInterior(playerid, 0);
+					server::spatial::player_grid.Refresh(playerid, player->Position());
 					SetPlayerCameraPos(playerid, 2096.242675, -1779.497558, 15.979070);
 					SetPlayerCameraLookAt(playerid, 2103.439697, -1783.191162, 14.913400, CAMERA_CUT);
 					RemovePlayerAttachedObject(playerid, INTRO_PROP_OBJECT_INDEX);
@@ -110,6 +111,7 @@ namespace auth
 							SetCameraBehindPlayer(playerid);
 							TogglePlayerControllable(playerid, true);
 							SetPlayerVirtualWorld(playerid, 0);
+							server::spatial::player_grid.Refresh(playerid);
 							player->Needs()->StartUpdating();
 							player->Needs()->ShowBars();
 
@@ -134,8 +136,8 @@ namespace auth
 	{
 		// Set-up the textdraws
 
-		auto* login_textdraws = textdraw_manager.LoadFile("auth.toml", "auth");
-		auto* pcustom_textdraws = textdraw_manager.LoadFile("player_customization.toml", "player_customization");
+		auto* login_textdraws = textdraw_manager["auth"];
+		auto* pcustom_textdraws = textdraw_manager["player_customization"];
 
 		// Login password input
 		login_textdraws->PlayerTextData()[2].callback = [](CPlayer* player) -> void {
@@ -206,6 +208,7 @@ namespace auth
 
 						SetPlayerVirtualWorld(playerid, player->VirtualWorld());
 						SetPlayerInterior(playerid, player->Interior());
+						server::spatial::player_grid.Refresh(playerid, { x, y, z });
 						SetPlayerHealth(playerid, player->Health());
 						SetPlayerArmour(playerid, player->Armor());
 						GivePlayerMoney(playerid, player->GetMoney());
@@ -245,6 +248,7 @@ namespace auth
 
 					SetPlayerInterior(playerid, 12);
 					SetPlayerVirtualWorld(playerid, 1 + playerid);
+					server::spatial::player_grid.Refresh(playerid, { 448.8462f, 508.5697f, 1001.4195f });
 					SetPlayerCameraPos(playerid, 449.177429f, 510.692901f, 1001.518493f);
 					SetPlayerCameraLookAt(playerid, 447.455413f, 506.018188f, 1001.092041f, CAMERA_CUT);
 					ApplyAnimation(playerid, "CRIB", "null", 0.f, false, false, false, false, 0, false);
@@ -376,7 +380,7 @@ namespace auth
 				return;
 			}
 
-			auto* textdraws = textdraw_manager.LoadFile("auth.toml", "auth");
+			auto* textdraws = textdraw_manager["auth"];
 			auto& global = textdraws->GetGlobalTextDraws();
 
 			auto stmt = server::database->Prepare(
@@ -434,31 +438,13 @@ namespace auth
 				textdraws->GetPlayerTextDraws(player)[2]->SetText("Tu contrasea");
 				textdraws->GetPlayerTextDraws(player)[3]->SetText("Mostrar contrasea");
 
-				global[7]->PushState();
-				global[19]->PushState();
-
-				global[7]->SetText("Cuenta registrada");
-
-				for (size_t i = 0; i <= 13; ++i)
-				{
-					global[i]->Show();
-				}
-
-				global[7]->PopState();
-				global[19]->SetText("Iniciar sesin");
-
-				for (size_t i = 18; i < global.size(); ++i)
-				{
-					global[i]->Show();
-				}
-
-				global[19]->PopState();
+				global[7]->SetTextFor(player, "Cuenta registrada");
+				global[19]->SetTextFor(player, "Iniciar sesin");
 
 				textdraws->GetPlayerTextDraws(player)[0]->SetText(fmt::format("ltimo inicio de sesin: ~y~{}", player->LastConnection()));
 				textdraws->GetPlayerTextDraws(player)[1]->SetText(player->Name());
 
-				for (size_t i = 0, count = textdraws->GetPlayerTextDraws(player).size() - 2; i <= count; ++i)
-					textdraws->GetPlayerTextDraws(player)[i]->Show();
+				textdraws->Show(player, "login");
 			}
 			else
 			{
@@ -469,7 +455,7 @@ namespace auth
 				textdraws->GetPlayerTextDraws(player)[2]->SetText("Tu contrasea");
 				textdraws->GetPlayerTextDraws(player)[3]->SetText("Mostrar contrasea");
 
-				textdraws->Show(player, 0, -1, 1, -1);
+				textdraws->Show(player, "register");
 			}
 
 			SelectTextDraw(playerid, 0xD2B567FF);
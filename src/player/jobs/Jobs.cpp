@@ -5,9 +5,7 @@ void jobs::CreatePickupSite(player::job jobid, glm::vec3 position, int vw, int i
 	std::string labelstring = fmt::format("Trabajo de {{ED2B2B}}{}{{DADADA}}\nPresione {{ED2B2B}}Y{{DADADA}} para empezar a trabajar\n{}", jobs::job_names[static_cast<size_t>(jobid)], extra_text);
 	
 	streamer::CreateDynamic3DTextLabel(labelstring, 0xDADADAFF, position.x, position.y, position.z, 10.f, INVALID_PLAYER_ID, INVALID_VEHICLE_ID, true, vw, interior);
-	int area = streamer::CreateDynamicCircle(position.x, position.y, 1.f, vw, interior);
-	cell info[3] = { 'JOB', static_cast<cell>(jobid), extra_data };
-	streamer::data::SetArrayData(streamer::STREAMER_TYPE_AREA, area, streamer::E_STREAMER_EXTRA_ID, info);
+	server::spatial::zones.Create(server::spatial::circle{ { position.x, position.y }, 1.f }, vw, interior, { server::spatial::zone_type::job, static_cast<std::int32_t>(jobid), extra_data });
 }
 
 static std::unordered_map<player::job, jobs::callback_t> _job_callbacks;
@@ -30,45 +28,38 @@ bool jobs::TriggerCallback(player::job jobid, CPlayer* player, jobs::event event
 public_hook _j_opksc("OnPlayerKeyStateChange", +[](std::uint16_t playerid, std::uint32_t newkeys, std::uint32_t oldkeys) {
 	if ((newkeys & KEY_YES) != 0)
 	{
-		auto areas = streamer::GetPlayerDynamicAreas(playerid);
-		auto* player = server::player_pool[playerid];
-
-		for (auto&& area : areas)
+		if (auto zone = server::spatial::zones.Find(playerid, server::spatial::zone_type::job))
 		{
-			cell info[3];
-			streamer::data::GetArrayData(streamer::STREAMER_TYPE_AREA, area, streamer::E_STREAMER_EXTRA_ID, info);
-			if (info[0] == 'JOB')
-			{
-				player::job job = static_cast<player::job>(info[1]);
-				auto& cb = _job_callbacks[job];
+			auto* player = server::player_pool[playerid];
+			player::job job = static_cast<player::job>(zone->id);
+			auto& cb = _job_callbacks[job];
 
-				if (player->Job() == player::job::none)
+			if (player->Job() == player::job::none)
+			{
+				if (cb)
 				{
-					if (cb)
+					if (!cb(player, jobs::event::join, zone->data))
 					{
-						if (!cb(player, jobs::event::join, info[2]))
-						{
-							return ~1;
-						}
+						return ~1;
 					}
-
-					player->Job() = job;
 				}
-				else if (player->Job() == job)
+
+				player->Job() = job;
+			}
+			else if (player->Job() == job)
+			{
+				if (cb)
 				{
-					if (cb)
+					if (!cb(player, jobs::event::leave, zone->data))
 					{
-						if (!cb(player, jobs::event::leave, info[2]))
-						{
-							return ~1;
-						}
+						return ~1;
 					}
-
-					player->Job() = player::job::none;
 				}
 
-				return ~1;
+				player->Job() = player::job::none;
 			}
+
+			return ~1;
 		}
 	}
 
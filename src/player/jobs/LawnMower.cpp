@@ -27,18 +27,15 @@ static void GenerateGrassInSquare(int park_id, glm::vec3 pos1, glm::vec3 pos2)
 {
 	for (int i = 0, j = Random::get(50, 100); i < j; ++i)
 	{
-		bool is_above_water{ false };
 		glm::vec3 grass_pos;
 
+		// Both lookups come from the baked heightmap of the park, they only raycast near edges and water
 		do
 		{
 			grass_pos = glm::linearRand(pos1, pos2);
-			is_above_water = (colandreas::RayCastLine(grass_pos.x, grass_pos.y, 100.f, grass_pos.x, grass_pos.y, -100.f, grass_pos.x, grass_pos.y, grass_pos.z) == colandreas::WATER_OBJECT);
-			if (grass_pos.z > 35.f)
-				is_above_water = true;
-		} while (is_above_water);
+			grass_pos.z = colandreas::FindZFor2DCoord(grass_pos.x, grass_pos.y, 100.f, -100.f);
+		} while (grass_pos.z > 35.f || colandreas::IsAboveWater(grass_pos.x, grass_pos.y, 100.f));
 
-		grass_pos.z = colandreas::FindZFor2DCoord(grass_pos.x, grass_pos.y, 100.f, -100.f);
 		auto grass_obj = streamer::CreateDynamicObject(817, grass_pos.x, grass_pos.y, grass_pos.z + 0.6, 0.0, 0.0, 0.0, 0, 0);
 		auto area = streamer::CreateDynamicCircle(grass_pos.x, grass_pos.y, 1.2, 0, 0, _lawnmower_areas[park_id].using_player->PlayerId());
 		cell info[2] = { 'MOW', grass_obj };
@@ -156,6 +153,15 @@ public_hook _j_lm_ogmi("OnGameModeInit", +[]() -> cell {
 	_lawnmower_areas[0].positions.area = { glm::vec3{ 2055.0747, -1248.8661, 23.8589 }, glm::vec3{ 1981.7301, -1148.3273, 21.2429 } };
 	_lawnmower_areas[0].positions.spawn = { 2052.7703, -1242.6202 ,23.6974, 85.6861 };
 
+	// Grass is placed with the heightmap of the park, bake the ones that are missing in the background
+	for (std::size_t i = 0; i < _lawnmower_areas.size(); ++i)
+	{
+		const auto& [min, max] = _lawnmower_areas[i].positions.area;
+		const auto path = std::filesystem::current_path() / "scriptfiles" / "heightmaps" / fmt::format("lawnmower_{}.hmap", i);
+		if (min != max && !std::filesystem::exists(path))
+			colandreas::baker.Start(path, { min.x, min.y }, { max.x, max.y }, 1.f);
+	}
+
 	jobs::CreatePickupSite(player::job::lawnmower, { 2081.5234, -1241.6908, 23.9750 }, 0, 0, 0);
 	jobs::SetJobCallback(player::job::lawnmower, LawnmowerEvent);
 
@@ -10,7 +10,7 @@ class CEnterExitManager
 			int interior;
 			int pickup;
 			int label;
-			int area;
+			std::uint32_t zone;
 		};
 
 		position_data enter;
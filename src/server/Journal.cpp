@@ -0,0 +1,282 @@
+#include "../main.hpp"
+
+server::journal::CJournalWriter server::journal::writer{};
+
+server::journal::CJournalWriter::~CJournalWriter()
+{
+	Stop();
+}
+
+bool server::journal::CJournalWriter::Start(const std::filesystem::path& directory)
+{
+	if (_thread.joinable())
+		return true;
+
+	std::error_code ec;
+	std::filesystem::create_directories(directory, ec);
+	if (ec)
+	{
+		sampgdk::logprintf("[journal] Couldn't create %s: %s.", directory.string().c_str(), ec.message().c_str());
+		return false;
+	}
+
+	_directory = directory;
+	_crc = Botan::HashFunction::create("CRC32");
+	_running.store(true, std::memory_order_release);
+	_thread = std::thread{ &CJournalWriter::Run, this };
+
+	sampgdk::logprintf("[journal] Writing chat and commands to %s.", directory.string().c_str());
+	return true;
+}
+
+void server::journal::CJournalWriter::Stop()
+{
+	if (!_thread.joinable())
+		return;
+
+	_running.store(false, std::memory_order_release);
+	_thread.join();
+
+	sampgdk::logprintf("[journal] Stopped: %u records written, %u dropped, %u lost to write errors.", Written(), _dropped, Failed());
+}
+
+void server::journal::CJournalWriter::Record(record_type type, CPlayer* player, std::string_view text)
+{
+	if (!Running())
+		return;
+
+	std::array<unsigned char, sizeof(stQueuedRecord) + MAX_NAME_LENGTH + MAX_TEXT_LENGTH> buffer;
+	const std::string_view name = std::string_view{ player->Name() }.substr(0, MAX_NAME_LENGTH);
+	text = text.substr(0, MAX_TEXT_LENGTH);
+
+	const stQueuedRecord queued{
+		std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count(),
+		player->AccountId(),
+		player->PlayerId(),
+		type,
+		static_cast<std::uint8_t>(name.length()),
+		static_cast<std::uint16_t>(text.length())
+	};
+
+	std::memcpy(buffer.data(), &queued, sizeof(queued));
+	std::memcpy(buffer.data() + sizeof(queued), name.data(), name.length());
+	std::memcpy(buffer.data() + sizeof(queued) + name.length(), text.data(), text.length());
+
+	// This is the only producer, the free space can't shrink between the check and the write
+	const auto size = sizeof(queued) + name.length() + text.length();
+	if (_ring.writeAvailable() < size)
+	{
+		++_dropped;
+		return;
+	}
+
+	_ring.writeBuff(buffer.data(), size);
+	++_queued;
+}
+
+void server::journal::CJournalWriter::Run()
+{
+	while (true)
+	{
+		// Read before draining: everything queued before Stop() was called is in the ring by now
+		const bool running = _running.load(std::memory_order_acquire);
+		const bool drained = Drain();
+
+		if (_block.record_count && (!running || std::chrono::steady_clock::now() - _block.started >= BLOCK_INTERVAL))
+			WriteBlock();
+
+		if (!running)
+			break;
+
+		if (!drained)
+			std::this_thread::sleep_for(POLL_INTERVAL);
+	}
+
+	CloseSegment();
+}
+
+bool server::journal::CJournalWriter::Drain()
+{
+	bool read = false;
+	stQueuedRecord queued;
+	std::array<unsigned char, MAX_NAME_LENGTH + MAX_TEXT_LENGTH> text;
+
+	while (_ring.readAvailable() >= sizeof(queued))
+	{
+		_ring.readBuff(reinterpret_cast<unsigned char*>(&queued), sizeof(queued));
+
+		// Records are written in one go, but don't rely on the ring publishing them in one go as well
+		const std::size_t length = queued.name_length + queued.text_length;
+		while (_ring.readAvailable() < length)
+			std::this_thread::yield();
+
+		_ring.readBuff(text.data(), length);
+
+		const auto* chars = reinterpret_cast<const char*>(text.data());
+		Append(queued, { chars, queued.name_length }, { chars + queued.name_length, queued.text_length });
+		read = true;
+	}
+
+	return read;
+}
+
+void server::journal::CJournalWriter::Append(const stQueuedRecord& queued, std::string_view name, std::string_view text)
+{
+	if (!_block.record_count)
+	{
+		_block.first_time = _block.last_time = _block.min_time = _block.max_time = queued.time;
+		_block.started = std::chrono::steady_clock::now();
+	}
+
+	// Zigzag, so a clock that went back costs as little as one that went forward
+	const auto delta = queued.time - _block.last_time;
+	WriteVarint(_block.data, (static_cast<std::uint64_t>(delta) << 1) ^ static_cast<std::uint64_t>(delta >> 63));
+	_block.data.push_back(static_cast<unsigned char>(queued.type));
+	WriteVarint(_block.data, queued.playerid);
+	WriteVarint(_block.data, queued.account);
+	WriteVarint(_block.data, name.length());
+	_block.data.insert(_block.data.end(), name.begin(), name.end());
+	WriteVarint(_block.data, text.length());
+	_block.data.insert(_block.data.end(), text.begin(), text.end());
+
+	_block.last_time = queued.time;
+	_block.min_time = std::min(_block.min_time, queued.time);
+	_block.max_time = std::max(_block.max_time, queued.time);
+	++_block.record_count;
+
+	const auto hash = NameHash(name);
+	if (std::find(_block.names.begin(), _block.names.end(), hash) == _block.names.end())
+		_block.names.push_back(hash);
+
+	if (_block.data.size() >= BLOCK_SIZE)
+		WriteBlock();
+}
+
+void server::journal::CJournalWriter::WriteBlock()
+{
+	if (!_block.record_count)
+		return;
+
+	if (!_segment.is_open() || _segment_size >= SEGMENT_SIZE || std::chrono::steady_clock::now() - _segment_started >= SEGMENT_INTERVAL)
+	{
+		CloseSegment();
+		OpenSegment();
+	}
+
+	if (_segment.is_open())
+	{
+		const stBlockHeader header{ static_cast<std::uint32_t>(_block.data.size()), Crc32(*_crc, _block.data.data(), _block.data.size()), _block.record_count, _block.first_time };
+		const auto offset = _segment_size;
+
+		_segment.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		_segment.write(reinterpret_cast<const char*>(_block.data.data()), _block.data.size());
+		_segment.flush();
+
+		// The index is only a shortcut, readers walk the blocks that are missing from it
+		std::sort(_block.names.begin(), _block.names.end());
+		const stIndexEntry entry{ offset, _block.min_time, _block.max_time, _block.record_count, static_cast<std::uint16_t>(std::min<std::size_t>(_block.names.size(), std::numeric_limits<std::uint16_t>::max())) };
+		_index.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+		_index.write(reinterpret_cast<const char*>(_block.names.data()), entry.name_count * sizeof(std::uint32_t));
+		_index.flush();
+
+		if (_segment)
+		{
+			_segment_size += sizeof(header) + _block.data.size();
+			_written.fetch_add(_block.record_count, std::memory_order_relaxed);
+		}
+		else
+		{
+			// Nothing sensible can follow a partial block, start over in a new segment
+			_failed.fetch_add(_block.record_count, std::memory_order_relaxed);
+			CloseSegment();
+		}
+	}
+	else
+	{
+		_failed.fetch_add(_block.record_count, std::memory_order_relaxed);
+	}
+
+	// Keep the capacity, blocks tend to be the same size
+	_block.data.clear();
+	_block.names.clear();
+	_block.record_count = 0u;
+}
+
+bool server::journal::CJournalWriter::OpenSegment()
+{
+	const auto now = std::chrono::system_clock::now();
+	auto path = _directory / fmt::format("{:%Y%m%d-%H%M%S}.jnl", fmt::localtime(std::chrono::system_clock::to_time_t(now)));
+
+	// A restart within the same second must not overwrite the previous segment
+	for (int i = 1; std::filesystem::exists(path); ++i)
+		path.replace_filename(fmt::format("{:%Y%m%d-%H%M%S}-{}.jnl", fmt::localtime(std::chrono::system_clock::to_time_t(now)), i));
+
+	_segment.open(path, std::ios::binary | std::ios::trunc);
+	_index.open(IndexPath(path), std::ios::binary | std::ios::trunc);
+	if (!_segment || !_index)
+	{
+		CloseSegment();
+		return false;
+	}
+
+	stSegmentHeader header{};
+	header.start_time = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+	_segment.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	const stIndexHeader index_header{};
+	_index.write(reinterpret_cast<const char*>(&index_header), sizeof(index_header));
+
+	_segment_path = std::move(path);
+	_segment_size = sizeof(header);
+	_segment_started = std::chrono::steady_clock::now();
+
+	RemoveOldSegments();
+	return true;
+}
+
+void server::journal::CJournalWriter::CloseSegment()
+{
+	_segment.close();
+	_index.close();
+	_segment.clear();
+	_index.clear();
+}
+
+void server::journal::CJournalWriter::RemoveOldSegments()
+{
+	std::error_code ec;
+	std::vector<std::filesystem::path> segments;
+	for (auto&& entry : std::filesystem::directory_iterator{ _directory, ec })
+	{
+		if (entry.is_regular_file() && entry.path().extension() == ".jnl")
+			segments.push_back(entry.path());
+	}
+
+	if (segments.size() <= MAX_SEGMENTS)
+		return;
+
+	// Names start with the date, so they sort from oldest to newest
+	std::sort(segments.begin(), segments.end());
+	for (std::size_t i = 0; i < segments.size() - MAX_SEGMENTS; ++i)
+	{
+		std::filesystem::remove(segments[i], ec);
+		std::filesystem::remove(IndexPath(segments[i]), ec);
+	}
+}
+
+static public_hook _jnl_ogmi("OnGameModeInit", +[]() -> cell {
+	server::journal::writer.Start(std::filesystem::current_path() / "scriptfiles" / "journal");
+	return 1;
+});
+
+static command journal_cmd("journal", command::make_flag<player::rank::admin>, [](CPlayer* player, cmd::argument_store args) {
+	auto& writer = server::journal::writer;
+	if (!writer.Running())
+	{
+		player->Chat()->Send(0xED2B2BFF, "[ERROR] {DADADA}El registro de chat y comandos no est activo.");
+		return;
+	}
+
+	player->Chat()->Send(0xDADADAFF, "Registro: {{ED2B2B}}{}{{DADADA}} encolados, {{ED2B2B}}{}{{DADADA}} escritos, {{ED2B2B}}{}{{DADADA}} descartados, {{ED2B2B}}{}{{DADADA}} con error.",
+		writer.Queued(), writer.Written(), writer.Dropped(), writer.Failed());
+});
@@ -0,0 +1,96 @@
+#pragma once
+
+// Append-only journal of what players say and which commands they run, for moderation.
+// The game thread only copies records into a lock-free ring; a background thread packs them into blocks and
+// appends them to segment files in scriptfiles/journal. Next to every segment, an index lists the time span
+// and the players of each block, so queries by player and time only read the blocks that can match.
+namespace server::journal
+{
+	class CJournalWriter
+	{
+		static constexpr std::size_t RING_SIZE = 1 << 20;
+		static constexpr std::size_t MAX_NAME_LENGTH = 24;
+		static constexpr std::size_t MAX_TEXT_LENGTH = 512;
+		static constexpr std::size_t BLOCK_SIZE = 64 * 1024; // A block is written once it's this big...
+		static constexpr auto BLOCK_INTERVAL = std::chrono::seconds{ 5 }; // ...or this old
+		static constexpr auto POLL_INTERVAL = std::chrono::milliseconds{ 100 };
+		static constexpr std::size_t SEGMENT_SIZE = 16 * 1024 * 1024;
+		static constexpr auto SEGMENT_INTERVAL = std::chrono::hours{ 1 };
+		static constexpr std::size_t MAX_SEGMENTS = 24 * 14; // Two weeks of hourly segments
+
+#pragma pack(push, 1)
+		// How a record travels through the ring, followed by the name and the text
+		struct stQueuedRecord
+		{
+			std::int64_t time;
+			std::uint32_t account;
+			std::uint16_t playerid;
+			record_type type;
+			std::uint8_t name_length;
+			std::uint16_t text_length;
+		};
+#pragma pack(pop)
+
+		struct block
+		{
+			std::vector<unsigned char> data;
+			std::uint32_t record_count{ 0u };
+			std::int64_t first_time{ 0 };
+			std::int64_t last_time{ 0 };
+			std::int64_t min_time{ 0 };
+			std::int64_t max_time{ 0 };
+			std::vector<std::uint32_t> names;
+			std::chrono::steady_clock::time_point started;
+		};
+
+		// Game thread side
+		jnk0le::Ringbuffer<unsigned char, RING_SIZE, false, 64> _ring;
+		std::size_t _queued{ 0u };
+		std::size_t _dropped{ 0u };
+
+		std::thread _thread;
+		std::atomic<bool> _running{ false };
+
+		// Journal thread side
+		std::filesystem::path _directory;
+		std::ofstream _segment;
+		std::ofstream _index;
+		std::filesystem::path _segment_path;
+		std::uint64_t _segment_size{ 0u };
+		std::chrono::steady_clock::time_point _segment_started;
+		block _block;
+		std::unique_ptr<Botan::HashFunction> _crc;
+		std::atomic<std::size_t> _written{ 0u };
+		std::atomic<std::size_t> _failed{ 0u };
+
+		void Run();
+		bool Drain();
+		void Append(const stQueuedRecord& queued, std::string_view name, std::string_view text);
+		void WriteBlock();
+		bool OpenSegment();
+		void CloseSegment();
+		void RemoveOldSegments();
+
+	public:
+		CJournalWriter() = default;
+		~CJournalWriter();
+
+		CJournalWriter(const CJournalWriter&) = delete;
+		CJournalWriter& operator=(const CJournalWriter&) = delete;
+
+		bool Start(const std::filesystem::path& directory);
+		// Writes whatever is still queued and waits for the journal thread
+		void Stop();
+
+		// Game thread only. Never blocks nor touches the disk, the record is dropped if the ring is full
+		void Record(record_type type, CPlayer* player, std::string_view text);
+
+		inline bool Running() const { return _running.load(std::memory_order_relaxed); }
+		inline std::size_t Queued() const { return _queued; }
+		inline std::size_t Dropped() const { return _dropped; }
+		inline std::size_t Written() const { return _written.load(std::memory_order_relaxed); }
+		inline std::size_t Failed() const { return _failed.load(std::memory_order_relaxed); }
+	};
+
+	extern CJournalWriter writer;
+}
@@ -0,0 +1,228 @@
+// Built into the query tool as well, so it can't pull in main.hpp
+#include "../pch.h"
+#include <botan/hash.h>
+#include "JournalFormat.hpp"
+
+std::uint32_t server::journal::NameHash(std::string_view name)
+{
+	// FNV-1a
+	std::uint32_t hash = 2166136261u;
+	for (unsigned char c : name)
+	{
+		hash ^= static_cast<unsigned char>(std::tolower(c));
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+bool server::journal::NameEquals(std::string_view a, std::string_view b)
+{
+	return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](unsigned char x, unsigned char y) {
+		return std::tolower(x) == std::tolower(y);
+	});
+}
+
+std::filesystem::path server::journal::IndexPath(const std::filesystem::path& segment)
+{
+	auto path = segment;
+	return path.replace_extension(".idx");
+}
+
+void server::journal::WriteVarint(std::vector<unsigned char>& out, std::uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back(static_cast<unsigned char>(value | 0x80));
+		value >>= 7;
+	}
+
+	out.push_back(static_cast<unsigned char>(value));
+}
+
+bool server::journal::ReadVarint(const unsigned char*& it, const unsigned char* end, std::uint64_t& value)
+{
+	value = 0u;
+	for (unsigned shift = 0; it != end && shift < 64; shift += 7)
+	{
+		const auto byte = *it++;
+		value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+			return true;
+	}
+
+	return false;
+}
+
+std::uint32_t server::journal::Crc32(Botan::HashFunction& hash, const unsigned char* data, std::size_t size)
+{
+	const auto bytes = hash.process(data, size);
+	return (bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+}
+
+server::journal::CJournalReader::CJournalReader(const std::filesystem::path& path)
+	: _file(path, std::ios::binary),
+	_path(path)
+{
+	if (!_file)
+		throw std::runtime_error{ "couldn't open journal segment" };
+
+	if (!_file.read(reinterpret_cast<char*>(&_header), sizeof(_header)) || _header.magic != SEGMENT_MAGIC)
+		throw std::runtime_error{ "not a journal segment" };
+
+	if (_header.version != JOURNAL_VERSION)
+		throw std::runtime_error{ "unsupported journal version" };
+
+	std::error_code ec;
+	_size = std::filesystem::file_size(path, ec);
+	if (ec)
+		_size = 0u;
+}
+
+std::optional<server::journal::stBlockHeader> server::journal::CJournalReader::ReadBlockHeader(std::uint64_t offset)
+{
+	_file.clear();
+	_file.seekg(offset);
+
+	stBlockHeader header;
+	if (!_file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+		return std::nullopt;
+
+	return header;
+}
+
+std::optional<server::journal::stBlockHeader> server::journal::CJournalReader::ReadBlock(std::uint64_t offset, const query& filter, const std::function<void(const record&)>& fn)
+{
+	auto block_header = ReadBlockHeader(offset);
+	if (!block_header)
+		return std::nullopt;
+
+	const auto& header = *block_header;
+
+	// A damaged size could ask for gigabytes. The segment may still be growing, so look again before giving up
+	const auto block_end = offset + sizeof(header) + header.size;
+	if (block_end > _size)
+	{
+		std::error_code ec;
+		_size = std::filesystem::file_size(_path, ec);
+		if (ec || block_end > _size)
+		{
+			++_damaged_blocks;
+			return std::nullopt;
+		}
+	}
+
+	std::vector<unsigned char> data(header.size);
+	if (!_file.read(reinterpret_cast<char*>(data.data()), data.size()))
+	{
+		++_damaged_blocks;
+		return std::nullopt;
+	}
+
+	if (Crc32(*Botan::HashFunction::create("CRC32"), data.data(), data.size()) != header.crc)
+	{
+		++_damaged_blocks;
+		return header;
+	}
+
+	const unsigned char* it = data.data();
+	const unsigned char* end = it + data.size();
+	auto read_string = [&it, end](std::string& out) {
+		std::uint64_t length;
+		if (!ReadVarint(it, end, length) || length > static_cast<std::uint64_t>(end - it))
+			return false;
+
+		out.assign(reinterpret_cast<const char*>(it), length);
+		it += length;
+		return true;
+	};
+
+	record entry;
+	entry.time = header.first_time;
+	for (std::uint32_t i = 0; i < header.record_count; ++i)
+	{
+		std::uint64_t delta, playerid, account;
+		if (!ReadVarint(it, end, delta) || it == end)
+		{
+			++_damaged_blocks;
+			break;
+		}
+
+		entry.time += static_cast<std::int64_t>(delta >> 1) ^ -static_cast<std::int64_t>(delta & 1);
+		entry.type = static_cast<record_type>(*it++);
+
+		if (!ReadVarint(it, end, playerid) || !ReadVarint(it, end, account) || !read_string(entry.name) || !read_string(entry.text))
+		{
+			++_damaged_blocks;
+			break;
+		}
+
+		entry.playerid = static_cast<std::uint16_t>(playerid);
+		entry.account = static_cast<std::uint32_t>(account);
+
+		if (entry.time < filter.from || entry.time > filter.to)
+			continue;
+
+		if (filter.type && entry.type != *filter.type)
+			continue;
+
+		if (filter.name && !NameEquals(entry.name, *filter.name))
+			continue;
+
+		fn(entry);
+	}
+
+	return header;
+}
+
+std::size_t server::journal::CJournalReader::Query(const query& filter, const std::function<void(const record&)>& fn)
+{
+	std::size_t matched = 0u;
+	auto counted = [&matched, &fn](const record& entry) {
+		++matched;
+		fn(entry);
+	};
+
+	const std::optional<std::uint32_t> name_hash = (filter.name ? std::optional{ NameHash(*filter.name) } : std::nullopt);
+	std::uint64_t offset = sizeof(stSegmentHeader);
+	std::optional<std::uint64_t> last_indexed;
+
+	std::ifstream index{ IndexPath(_path), std::ios::binary };
+	stIndexHeader index_header;
+	if (index && index.read(reinterpret_cast<char*>(&index_header), sizeof(index_header)) && index_header.magic == INDEX_MAGIC && index_header.version == JOURNAL_VERSION)
+	{
+		stIndexEntry entry;
+		std::vector<std::uint32_t> names;
+		while (index.read(reinterpret_cast<char*>(&entry), sizeof(entry)))
+		{
+			names.resize(entry.name_count);
+			if (!index.read(reinterpret_cast<char*>(names.data()), names.size() * sizeof(std::uint32_t)))
+				break;
+
+			last_indexed = entry.offset;
+
+			// Blocks that can't match aren't even read
+			if (entry.max_time < filter.from || entry.min_time > filter.to || (name_hash && !std::binary_search(names.begin(), names.end(), *name_hash)))
+				continue;
+
+			ReadBlock(entry.offset, filter, counted);
+		}
+	}
+
+	if (last_indexed)
+	{
+		auto header = ReadBlockHeader(*last_indexed);
+		if (!header)
+			return matched;
+
+		offset = *last_indexed + sizeof(*header) + header->size;
+	}
+
+	// The index is written after the block, a crash may leave the last blocks out of it
+	while (auto header = ReadBlock(offset, filter, counted))
+	{
+		offset += sizeof(*header) + header->size;
+	}
+
+	return matched;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+// On-disk format of the chat and command journal and the reader for it. Shared by the plugin and the offline
+// query tool, so it only depends on the standard library and Botan.
+namespace server::journal
+{
+	constexpr std::uint32_t SEGMENT_MAGIC = 'THJL';
+	constexpr std::uint32_t INDEX_MAGIC = 'THJI';
+	constexpr std::uint16_t JOURNAL_VERSION = 1;
+
+	enum class record_type : std::uint8_t
+	{
+		chat,
+		command
+	};
+
+#pragma pack(push, 1)
+	struct stSegmentHeader
+	{
+		std::uint32_t magic{ SEGMENT_MAGIC };
+		std::uint16_t version{ JOURNAL_VERSION };
+		std::uint16_t reserved{ 0 };
+		std::int64_t start_time{ 0 }; // Unix time, milliseconds
+	};
+
+	// Each block is followed by `size` bytes of packed records: the time as a zigzag varint delta from the
+	// previous record (the first one from `first_time`), the type, the player ID and account ID as varints and
+	// the name and text, each prefixed by its length as a varint.
+	struct stBlockHeader
+	{
+		std::uint32_t size;
+		std::uint32_t crc; // CRC32 of the packed records
+		std::uint32_t record_count;
+		std::int64_t first_time;
+	};
+
+	struct stIndexHeader
+	{
+		std::uint32_t magic{ INDEX_MAGIC };
+		std::uint16_t version{ JOURNAL_VERSION };
+		std::uint16_t reserved{ 0 };
+	};
+
+	// Each entry is followed by `name_count` sorted hashes of the player names in the block, see NameHash
+	struct stIndexEntry
+	{
+		std::uint64_t offset; // Of the block header in the segment
+		std::int64_t min_time; // The clock may go back, records aren't necessarily sorted by time
+		std::int64_t max_time;
+		std::uint32_t record_count;
+		std::uint16_t name_count;
+	};
+#pragma pack(pop)
+
+	struct record
+	{
+		std::int64_t time; // Unix time, milliseconds
+		record_type type;
+		std::uint16_t playerid;
+		std::uint32_t account;
+		std::string name;
+		std::string text;
+	};
+
+	// Case insensitive, player names can't differ only in case
+	std::uint32_t NameHash(std::string_view name);
+	// Records are matched by name with this, the hash can collide
+	bool NameEquals(std::string_view a, std::string_view b);
+
+	std::filesystem::path IndexPath(const std::filesystem::path& segment);
+
+	void WriteVarint(std::vector<unsigned char>& out, std::uint64_t value);
+	bool ReadVarint(const unsigned char*& it, const unsigned char* end, std::uint64_t& value);
+
+	std::uint32_t Crc32(Botan::HashFunction& hash, const unsigned char* data, std::size_t size);
+
+	struct query
+	{
+		std::optional<std::string> name;
+		std::optional<record_type> type;
+		std::int64_t from{ std::numeric_limits<std::int64_t>::min() };
+		std::int64_t to{ std::numeric_limits<std::int64_t>::max() };
+	};
+
+	// Reads a segment, using its index to skip blocks when there is one
+	class CJournalReader
+	{
+		std::ifstream _file;
+		std::filesystem::path _path;
+		stSegmentHeader _header{};
+		std::uint64_t _size{ 0u };
+		std::size_t _damaged_blocks{ 0u };
+
+		std::optional<stBlockHeader> ReadBlockHeader(std::uint64_t offset);
+		// Nothing past the end of the segment, a damaged block is counted and skipped
+		std::optional<stBlockHeader> ReadBlock(std::uint64_t offset, const query& filter, const std::function<void(const record&)>& fn);
+
+	public:
+		explicit CJournalReader(const std::filesystem::path& path);
+
+		// Calls `fn` for every record that matches, in the order they were written. Returns how many matched
+		std::size_t Query(const query& filter, const std::function<void(const record&)>& fn);
+
+		inline const stSegmentHeader& Header() const { return _header; }
+		inline std::size_t DamagedBlocks() const { return _damaged_blocks; }
+	};
+}
@@ -24,7 +24,7 @@ static public_hook _cmd_opct("OnPlayerCommandText", [](std::uint16_t playerid, s
 			auto* command = commands::_commands->at(command_name);
 			auto flags = static_cast<uint32_t>(command->Flags());
 
-			if ((flags >> 16) > player->Rank())
+			if (command::required_rank(command->Flags()) > player->Rank())
 				return ~1;
 
 			if (!(flags & command::flags::no_cooldown) && std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - player->LastCommandTick()) < cmd::time_between_commands)
@@ -43,6 +43,7 @@ static public_hook _cmd_opct("OnPlayerCommandText", [](std::uint16_t playerid, s
 			}
 
 			player->LastCommandTick() = std::chrono::steady_clock::now();
+			server::journal::writer.Record(server::journal::record_type::command, player, cmdtext);
 
 			std::string args;
 
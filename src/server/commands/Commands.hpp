@@ -20,8 +20,11 @@ public:
 
 		max_flag
 	};
-	static_assert(static_cast<int>(flags::max_flag) < 16777216 + 1);
-	template<std::uint8_t Rank> static inline constexpr flags make_flag = static_cast<flags>(Rank << 24);
+	// The required rank lives in the top byte, above every flag
+	static constexpr int RANK_SHIFT = 24;
+	static_assert(static_cast<int>(flags::max_flag) <= (1 << RANK_SHIFT));
+	template<std::uint8_t Rank> static inline constexpr flags make_flag = static_cast<flags>(Rank << RANK_SHIFT);
+	static inline constexpr std::uint8_t required_rank(flags flags) { return static_cast<std::uint32_t>(flags) >> RANK_SHIFT; }
 
 private:
 	void Register(const std::string_view name)
@@ -0,0 +1,325 @@
+#include "../../../main.hpp"
+
+colandreas::CHeightmapSet colandreas::heightmaps{};
+colandreas::CHeightmapBaker colandreas::baker{};
+
+colandreas::CHeightmap::CHeightmap(const std::filesystem::path& path)
+	: _file(path)
+{
+	if (_file.size() < sizeof(stHeightmapHeader))
+		throw std::runtime_error{ "not a heightmap file" };
+
+	_header = reinterpret_cast<const stHeightmapHeader*>(_file.data());
+	if (_header->magic != HEIGHTMAP_MAGIC)
+		throw std::runtime_error{ "not a heightmap file" };
+
+	if (_header->version != HEIGHTMAP_VERSION)
+		throw std::runtime_error{ "unsupported heightmap version" };
+
+	if (_header->width < 2 || _header->height < 2 || !(_header->cell_size > 0.f))
+		throw std::runtime_error{ "invalid heightmap dimensions" };
+
+	const std::size_t samples = static_cast<std::size_t>(_header->width) * _header->height;
+	if (_file.size() != sizeof(stHeightmapHeader) + samples * sizeof(float) + (samples + 7) / 8)
+		throw std::runtime_error{ "truncated heightmap file" };
+
+	_heights = reinterpret_cast<const float*>(_file.data() + sizeof(stHeightmapHeader));
+	_water = reinterpret_cast<const std::uint8_t*>(_heights + samples);
+}
+
+std::optional<colandreas::ground_sample> colandreas::CHeightmap::Lookup(float x, float y) const
+{
+	const float fx = (x - _header->origin_x) / _header->cell_size;
+	const float fy = (y - _header->origin_y) / _header->cell_size;
+	if (!(fx >= 0.f && fy >= 0.f && fx <= _header->width - 1 && fy <= _header->height - 1))
+		return std::nullopt;
+
+	const auto i = std::min(static_cast<std::uint32_t>(fx), _header->width - 2);
+	const auto j = std::min(static_cast<std::uint32_t>(fy), _header->height - 2);
+	const float tx = fx - i, ty = fy - j;
+
+	const std::size_t index[4] = {
+		static_cast<std::size_t>(j) * _header->width + i,
+		static_cast<std::size_t>(j) * _header->width + i + 1,
+		static_cast<std::size_t>(j + 1) * _header->width + i,
+		static_cast<std::size_t>(j + 1) * _header->width + i + 1
+	};
+
+	const float z00 = _heights[index[0]], z10 = _heights[index[1]], z01 = _heights[index[2]], z11 = _heights[index[3]];
+	const bool water = IsWater(index[0]);
+
+	// Also rejects samples where nothing was hit, comparisons with NaN are always false
+	const float min_z = std::min({ z00, z10, z01, z11 }), max_z = std::max({ z00, z10, z01, z11 });
+	if (!(max_z - min_z <= MAX_INTERPOLATION_STEP))
+		return std::nullopt;
+
+	if (IsWater(index[1]) != water || IsWater(index[2]) != water || IsWater(index[3]) != water)
+		return std::nullopt;
+
+	const float z0 = z00 + (z10 - z00) * tx;
+	const float z1 = z01 + (z11 - z01) * tx;
+	return ground_sample{ z0 + (z1 - z0) * ty, water };
+}
+
+bool colandreas::CHeightmapSet::Add(const std::filesystem::path& path)
+{
+	try
+	{
+		auto map = std::make_unique<CHeightmap>(path);
+		auto name = path.stem().string();
+
+		// A re-baked map replaces the old one
+		Remove(name);
+		_maps.emplace_back(std::move(name), std::move(map));
+		return true;
+	}
+	catch (const std::exception& e)
+	{
+		sampgdk::logprintf("[heightmap] Couldn't load %s: %s.", path.string().c_str(), e.what());
+		return false;
+	}
+}
+
+void colandreas::CHeightmapSet::Remove(const std::string& name)
+{
+	std::erase_if(_maps, [&name](const auto& entry) { return entry.first == name; });
+}
+
+std::unique_ptr<colandreas::CHeightmap> colandreas::CHeightmapSet::Take(const std::string& name)
+{
+	auto it = std::find_if(_maps.begin(), _maps.end(), [&name](const auto& entry) { return entry.first == name; });
+	if (it == _maps.end())
+		return nullptr;
+
+	auto map = std::move(it->second);
+	_maps.erase(it);
+	return map;
+}
+
+void colandreas::CHeightmapSet::Put(std::string name, std::unique_ptr<CHeightmap> map)
+{
+	Remove(name);
+	_maps.emplace_back(std::move(name), std::move(map));
+}
+
+std::size_t colandreas::CHeightmapSet::Load(const std::filesystem::path& directory)
+{
+	std::error_code ec;
+	if (!std::filesystem::is_directory(directory, ec))
+		return 0u;
+
+	std::size_t count = 0u;
+	for (auto&& entry : std::filesystem::directory_iterator{ directory, ec })
+	{
+		if (entry.is_regular_file() && entry.path().extension() == ".hmap" && Add(entry.path()))
+			++count;
+	}
+
+	return count;
+}
+
+std::optional<colandreas::ground_sample> colandreas::CHeightmapSet::Lookup(float x, float y) const
+{
+	for (auto&& [name, map] : _maps)
+	{
+		if (auto sample = map->Lookup(x, y))
+			return sample;
+	}
+
+	return std::nullopt;
+}
+
+bool colandreas::CHeightmapBaker::Start(const std::filesystem::path& path, glm::vec2 min, glm::vec2 max, float cell_size)
+{
+	if (!(cell_size > 0.f))
+		return false;
+
+	const auto lo = glm::min(min, max), hi = glm::max(min, max);
+	const auto width = static_cast<std::uint32_t>(std::ceil((hi.x - lo.x) / cell_size)) + 1;
+	const auto height = static_cast<std::uint32_t>(std::ceil((hi.y - lo.y) / cell_size)) + 1;
+	if (width < 2 || height < 2 || static_cast<std::size_t>(width) * height > MAX_SAMPLES)
+		return false;
+
+	bake_job job;
+	job.path = path;
+	job.header.origin_x = lo.x;
+	job.header.origin_y = lo.y;
+	job.header.cell_size = cell_size;
+	job.header.width = width;
+	job.header.height = height;
+	job.heights.resize(static_cast<std::size_t>(width) * height);
+	job.water.resize((job.heights.size() + 7) / 8);
+	_jobs.push_back(std::move(job));
+
+	sampgdk::logprintf("[heightmap] Queued %ux%u samples to bake into %s.", width, height, path.string().c_str());
+
+	// The timer is already running for the jobs in front of this one
+	if (_jobs.size() == 1)
+	{
+		timers::timer_manager->Repeat(1, 1, [](timers::CTimer* timer) {
+			baker.Step(timer);
+		});
+	}
+
+	return true;
+}
+
+void colandreas::CHeightmapBaker::Step(timers::CTimer* timer)
+{
+	auto& job = _jobs.front();
+	const auto& header = job.header;
+
+	static std::array<ray_segment, SAMPLES_PER_BATCH> segments;
+	static std::array<ray_hit, SAMPLES_PER_BATCH> hits;
+
+	const auto start = std::chrono::steady_clock::now();
+	do
+	{
+		const auto count = std::min(SAMPLES_PER_BATCH, job.heights.size() - job.next);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const auto index = job.next + i;
+			const float x = header.origin_x + (index % header.width) * header.cell_size;
+			const float y = header.origin_y + (index / header.width) * header.cell_size;
+			segments[i] = { { x, y, BAKE_TOP_Z }, { x, y, BAKE_BOTTOM_Z } };
+		}
+
+		RayCastLines({ segments.data(), count }, { hits.data(), count });
+
+		for (std::size_t i = 0; i < count; ++i, ++job.next)
+		{
+			job.heights[job.next] = (hits[i].model != 0 ? hits[i].position.z : std::numeric_limits<float>::quiet_NaN());
+			if (hits[i].model == WATER_OBJECT)
+				job.water[job.next >> 3] |= static_cast<std::uint8_t>(1u << (job.next & 7));
+		}
+	} while (job.next < job.heights.size() && std::chrono::steady_clock::now() - start < TICK_BUDGET);
+
+	if (job.next < job.heights.size())
+		return;
+
+	if (Write(job))
+		sampgdk::logprintf("[heightmap] Finished baking %s.", job.path.string().c_str());
+
+	_jobs.pop_front();
+	if (!_jobs.empty())
+		return;
+
+	timer->Killed() = true;
+	timers::timer_manager->Delete(timer);
+}
+
+bool colandreas::CHeightmapBaker::Write(const bake_job& job)
+{
+	std::error_code ec;
+	std::filesystem::create_directories(job.path.parent_path(), ec);
+
+	// Write to a temporary file first, the old map may still be mapped
+	auto temp_path = job.path;
+	temp_path += ".tmp";
+
+	{
+		std::ofstream file{ temp_path, std::ios::binary | std::ios::trunc };
+		file.write(reinterpret_cast<const char*>(&job.header), sizeof(job.header));
+		file.write(reinterpret_cast<const char*>(job.heights.data()), job.heights.size() * sizeof(float));
+		file.write(reinterpret_cast<const char*>(job.water.data()), job.water.size());
+
+		if (!file)
+		{
+			sampgdk::logprintf("[heightmap] Couldn't write %s.", temp_path.string().c_str());
+			std::filesystem::remove(temp_path, ec);
+			return false;
+		}
+	}
+
+	// Windows won't replace a file that is still mapped, so the old map is unmapped for the rename and put
+	// back if it fails. Nothing can look it up in between, lookups also run on the game thread.
+	const auto name = job.path.stem().string();
+	auto old_map = heightmaps.Take(name);
+	std::filesystem::rename(temp_path, job.path, ec);
+	if (ec)
+	{
+		sampgdk::logprintf("[heightmap] Couldn't replace %s: %s.", job.path.string().c_str(), ec.message().c_str());
+		if (old_map)
+			heightmaps.Put(name, std::move(old_map));
+
+		std::filesystem::remove(temp_path, ec);
+		return false;
+	}
+
+	old_map.reset();
+	return heightmaps.Add(job.path);
+}
+
+static public_hook _hm_ogmi("OnGameModeInit", +[]() -> cell {
+	auto count = colandreas::heightmaps.Load(std::filesystem::current_path() / "scriptfiles" / "heightmaps");
+	sampgdk::logprintf("[heightmap] Loaded %u heightmaps.", count);
+	return 1;
+});
+
+static command heightmap_cmd("heightmap", command::make_flag<player::rank::admin>, [](CPlayer* player, cmd::argument_store args) {
+	std::string action;
+
+	try
+	{
+		args >> action;
+	}
+	catch (const std::exception& e)
+	{
+		player->Chat()->Send(0xDADADAFF, "USO: {ED2B2B}/heightmap{DADADA} <bake/reload/status>");
+		return;
+	}
+
+	if (action == "bake")
+	{
+		std::string name;
+		glm::vec2 min, max;
+		float cell_size{ 1.f };
+
+		try
+		{
+			args >> name >> min.x >> min.y >> max.x >> max.y;
+			if (!args.empty())
+				args >> cell_size;
+		}
+		catch (const std::exception& e)
+		{
+			player->Chat()->Send(0xDADADAFF, "USO: {ED2B2B}/heightmap bake{DADADA} <nombre> <min x> <min y> <max x> <max y> [tamao de celda]");
+			return;
+		}
+
+		if (name.empty() || !std::all_of(name.begin(), name.end(), [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-'; }))
+		{
+			player->Chat()->Send(0xED2B2BFF, "[ERROR] {DADADA}El nombre solo puede tener letras, nmeros, guiones y guiones bajos.");
+			return;
+		}
+
+		if (!colandreas::baker.Start(std::filesystem::current_path() / "scriptfiles" / "heightmaps" / (name + ".hmap"), min, max, cell_size))
+		{
+			player->Chat()->Send(0xED2B2BFF, "[ERROR] {DADADA}La zona es demasiado grande o el tamao de celda no es vlido.");
+			return;
+		}
+
+		player->Chat()->Send(0xDADADAFF, "Generando el mapa de alturas {{ED2B2B}}{}{{DADADA}}.", name);
+	}
+	else if (action == "reload")
+	{
+		colandreas::heightmaps.Clear();
+		auto count = colandreas::heightmaps.Load(std::filesystem::current_path() / "scriptfiles" / "heightmaps");
+		player->Chat()->Send(0xDADADAFF, "Se han cargado {{ED2B2B}}{}{{DADADA}} mapas de alturas.", count);
+	}
+	else if (action == "status")
+	{
+		if (colandreas::baker.Baking())
+			player->Chat()->Send(0xDADADAFF, "Generando mapa de alturas: {{ED2B2B}}{:.0f}%{{DADADA}}.", colandreas::baker.Progress() * 100.f);
+
+		for (auto&& [name, map] : colandreas::heightmaps.Maps())
+		{
+			const auto& header = map->Header();
+			player->Chat()->Send(0xDADADAFF, "{{ED2B2B}}{}{{DADADA}}: {}x{} muestras de {:.2f}m desde ({:.1f}, {:.1f}), {} KB", name, header.width, header.height, header.cell_size, header.origin_x, header.origin_y, map->Size() / 1024);
+		}
+	}
+	else
+	{
+		player->Chat()->Send(0xDADADAFF, "USO: {ED2B2B}/heightmap{DADADA} <bake/reload/status>");
+	}
+});
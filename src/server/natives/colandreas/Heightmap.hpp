@@ -0,0 +1,108 @@
+#pragma once
+
+namespace colandreas
+{
+	constexpr std::uint32_t HEIGHTMAP_MAGIC = 'THHM';
+	constexpr std::uint16_t HEIGHTMAP_VERSION = 1;
+
+#pragma pack(push, 1)
+	// The header is followed by `width * height` floats with the ground Z of every sample (row major, NaN where
+	// the ray hit nothing) and by a bitmask with one bit per sample, set when the first hit was water.
+	struct stHeightmapHeader
+	{
+		std::uint32_t magic{ HEIGHTMAP_MAGIC };
+		std::uint16_t version{ HEIGHTMAP_VERSION };
+		std::uint16_t reserved{ 0 };
+		float origin_x{ 0.f };
+		float origin_y{ 0.f };
+		float cell_size{ 1.f };
+		std::uint32_t width{ 0 };
+		std::uint32_t height{ 0 };
+	};
+#pragma pack(pop)
+
+	struct ground_sample
+	{
+		float z;
+		bool water;
+	};
+
+	class CHeightmap
+	{
+		// Corners further apart than this are a wall or a ledge, interpolating between them is meaningless
+		static constexpr float MAX_INTERPOLATION_STEP = 1.5f;
+
+		utils::mapped_file _file;
+		const stHeightmapHeader* _header{ nullptr };
+		const float* _heights{ nullptr };
+		const std::uint8_t* _water{ nullptr };
+
+		inline bool IsWater(std::size_t index) const { return (_water[index >> 3] >> (index & 7)) & 1; }
+
+	public:
+		explicit CHeightmap(const std::filesystem::path& path);
+
+		// Bilinear ground Z at the given point. Returns nothing when the point is outside the map or the
+		// surrounding samples don't agree (shorelines, building edges), callers should raycast then.
+		std::optional<ground_sample> Lookup(float x, float y) const;
+
+		inline const stHeightmapHeader& Header() const { return *_header; }
+		inline std::size_t Size() const { return _file.size(); }
+	};
+
+	class CHeightmapSet
+	{
+		std::vector<std::pair<std::string, std::unique_ptr<CHeightmap>>> _maps;
+
+	public:
+		bool Add(const std::filesystem::path& path);
+		void Remove(const std::string& name);
+
+		// Unloads a map but hands it back, so it can be put back if replacing its file fails
+		std::unique_ptr<CHeightmap> Take(const std::string& name);
+		void Put(std::string name, std::unique_ptr<CHeightmap> map);
+		std::size_t Load(const std::filesystem::path& directory);
+		inline void Clear() { _maps.clear(); }
+
+		std::optional<ground_sample> Lookup(float x, float y) const;
+
+		inline const auto& Maps() const { return _maps; }
+	};
+
+	// Bakes heightmaps with real raycasts, one job after another. Every tick casts batches of rays until the
+	// time budget runs out, so a bake never stalls the game no matter how slow the collision lookups are.
+	class CHeightmapBaker
+	{
+		static constexpr std::size_t SAMPLES_PER_BATCH = 128;
+		static constexpr auto TICK_BUDGET = std::chrono::microseconds{ 1500 };
+		static constexpr float BAKE_TOP_Z = 700.f;
+		static constexpr float BAKE_BOTTOM_Z = -1000.f;
+
+	public:
+		static constexpr std::size_t MAX_SAMPLES = 2048 * 2048;
+
+	private:
+		struct bake_job
+		{
+			std::filesystem::path path;
+			stHeightmapHeader header;
+			std::vector<float> heights;
+			std::vector<std::uint8_t> water;
+			std::size_t next{ 0u };
+		};
+
+		std::deque<bake_job> _jobs;
+
+		void Step(timers::CTimer* timer);
+		bool Write(const bake_job& job);
+
+	public:
+		bool Start(const std::filesystem::path& path, glm::vec2 min, glm::vec2 max, float cell_size);
+
+		inline bool Baking() const { return !_jobs.empty(); }
+		inline float Progress() const { return Baking() ? static_cast<float>(_jobs.front().next) / _jobs.front().heights.size() : 1.f; }
+	};
+
+	extern CHeightmapSet heightmaps;
+	extern CHeightmapBaker baker;
+}
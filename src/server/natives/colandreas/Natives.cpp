@@ -1,5 +1,13 @@
 #include "../../../main.hpp"
 
+// Fake AMX heap helpers from the sampgdk amalgamation we link against, sampgdk.h doesn't declare them
+extern "C"
+{
+	int sampgdk_fakeamx_push_array(const cell* src, int size, cell* address);
+	void sampgdk_fakeamx_get_array(cell address, cell* dest, int size);
+	void sampgdk_fakeamx_pop(cell address);
+}
+
 bool colandreas::Init()
 {
 	static AMX_NATIVE native = sampgdk::FindNative("CA_Init");
@@ -12,8 +20,54 @@ int colandreas::RayCastLine(float StartX, float StartY, float StartZ, float EndX
 	return sampgdk::InvokeNative(native, "ffffffRRR", StartX, StartY, StartZ, EndX, EndY, EndZ, &x, &y, &z);
 }
 
+void colandreas::RayCastLines(std::span<const ray_segment> segments, std::span<ray_hit> hits)
+{
+	static AMX_NATIVE native = sampgdk::FindNative("CA_RayCastLine");
+
+	// InvokeNative parses the format string and pushes/pops every reference on each call, here the three
+	// output cells are allocated once and the parameters are laid out by hand
+	cell output[3]{};
+	cell address;
+	if (sampgdk_fakeamx_push_array(output, 3, &address) < 0)
+		return;
+
+	cell params[10];
+	params[0] = 9 * sizeof(cell);
+	params[7] = address;
+	params[8] = address + sizeof(cell);
+	params[9] = address + 2 * sizeof(cell);
+
+	for (std::size_t i = 0, count = std::min(segments.size(), hits.size()); i < count; ++i)
+	{
+		const auto& segment = segments[i];
+		params[1] = std::bit_cast<cell>(segment.start.x);
+		params[2] = std::bit_cast<cell>(segment.start.y);
+		params[3] = std::bit_cast<cell>(segment.start.z);
+		params[4] = std::bit_cast<cell>(segment.end.x);
+		params[5] = std::bit_cast<cell>(segment.end.y);
+		params[6] = std::bit_cast<cell>(segment.end.z);
+
+		hits[i].model = sampgdk::CallNative(native, params);
+		if (hits[i].model != 0)
+		{
+			sampgdk_fakeamx_get_array(address, output, 3);
+			hits[i].position = { std::bit_cast<float>(output[0]), std::bit_cast<float>(output[1]), std::bit_cast<float>(output[2]) };
+		}
+		else
+		{
+			hits[i].position = segment.end;
+		}
+	}
+
+	sampgdk_fakeamx_pop(address);
+}
+
 float colandreas::FindZFor2DCoord(float x, float y, float init_z, float end_z)
 {
+	// The baked top surface is what the ray would hit first as long as it lies inside the requested range
+	if (auto sample = heightmaps.Lookup(x, y); sample && sample->z <= init_z && sample->z >= end_z)
+		return sample->z;
+
 	float z;
 	colandreas::RayCastLine(x, y, init_z, x, y, end_z, x, y, z);
 	return z;
@@ -21,5 +75,8 @@ float colandreas::FindZFor2DCoord(float x, float y, float init_z, float end_z)
 
 bool colandreas::IsAboveWater(float x, float y, float z)
 {
+	if (auto sample = heightmaps.Lookup(x, y); sample && sample->z <= z)
+		return sample->water;
+
 	return colandreas::RayCastLine(x, y, z, x, y, -1000.f, x, y, z) == WATER_OBJECT;
 }
@@ -4,8 +4,22 @@ namespace colandreas
 {
 	constexpr auto WATER_OBJECT = 20000;
 
+	struct ray_segment
+	{
+		glm::vec3 start;
+		glm::vec3 end;
+	};
+
+	struct ray_hit
+	{
+		glm::vec3 position; // Segment end when nothing was hit
+		int model{ 0 }; // 0 when nothing was hit, WATER_OBJECT for water
+	};
+
 	bool Init();
 	int RayCastLine(float StartX, float StartY, float StartZ, float EndX, float EndY, float EndZ, float& x, float& y, float& z);
+	// Casts every segment with a single native lookup and one set of output cells, `hits` must be as large as `segments`
+	void RayCastLines(std::span<const ray_segment> segments, std::span<ray_hit> hits);
 
 	float FindZFor2DCoord(float x, float y, float init_z = 700.f, float end_z = -1000.f);
 	bool IsAboveWater(float x, float y, float z);
@@ -17,10 +17,7 @@ shops::CShop* shops::CShopManager::Create(const std::string& name, glm::vec3 pos
 	shop->cam_look_at = camera.second;
 	shop->position = position;
 	shop->label = streamer::CreateDynamic3DTextLabel(fmt::format("{{ED2B2B}}{}\n{{DADADA}}Presiona {{ED2B2B}}Y {{DADADA}}para ver el inventario", name), 0xED2B2BFF, position.x, position.y, position.z, 10.f, INVALID_PLAYER_ID, INVALID_VEHICLE_ID, 1, world, interior);
-	shop->area = streamer::CreateDynamicCircle(position.x, position.y, 1.f, world, interior);
-	
-	cell info[2] = { 'SHOP', static_cast<cell>(_shops.size()) };
-	streamer::data::SetArrayData(streamer::STREAMER_TYPE_AREA, shop->area, streamer::E_STREAMER_EXTRA_ID, info);
+	shop->zone = server::spatial::zones.Create(server::spatial::circle{ { position.x, position.y }, 1.f }, world, interior, { server::spatial::zone_type::shop, static_cast<std::int32_t>(_shops.size()) });
 
 	_shops.push_back(std::move(shop));
 	return _shops.back().get();
@@ -73,46 +70,37 @@ cell shops::OnPlayerKeyStateChange(std::uint16_t playerid, std::uint32_t newkeys
 {
 	if ((newkeys & KEY_YES) != 0)
 	{
-		auto areas = streamer::GetPlayerDynamicAreas(playerid);
-		if (!areas.empty())
+		if (auto zone = server::spatial::zones.Find(playerid, server::spatial::zone_type::shop))
 		{
 			auto* player = server::player_pool[playerid];
 
-			for (auto&& area : areas)
-			{
-				cell info[2]{};
-				streamer::data::GetArrayData(streamer::STREAMER_TYPE_AREA, area, streamer::E_STREAMER_EXTRA_ID, info);
-				if (info[0] == 'SHOP')
-				{
-					player->Flags().set(player::flags::can_use_shop_buttons, true);
-					player->Flags().set(player::flags::using_shop, true);
-
-					auto& shop = shop_manager->_shops[info[1]];
-					player->CurrentShop() = shop.get();
-
-					auto* textdraws = textdraw_manager["shop"];
-					auto& shop_item = shop->_shop_items.front();
-
-					textdraws->GetPlayerTextDraws(player)[0]->SetText(shop->name);
-					textdraws->GetPlayerTextDraws(player)[1]->SetText(fmt::format("${}", shop_item->price));
-					textdraws->GetPlayerTextDraws(player)[2]->SetText(shop_item->name);
-					textdraws->Show(player);
-
-					glm::vec3 cam_pos, cam_vec;
-					GetPlayerCameraPos(playerid, &cam_pos.x, &cam_pos.y, &cam_pos.z);
-					GetPlayerCameraFrontVector(playerid, &cam_vec.x, &cam_vec.y, &cam_vec.z);
-					InterpolateCameraPos(playerid, cam_pos.x, cam_pos.y, cam_pos.z, shop->cam_pos.x, shop->cam_pos.y, shop->cam_pos.z, 1000, CAMERA_CUT);
-					InterpolateCameraLookAt(playerid, cam_vec.x, cam_vec.y, cam_vec.z, shop->cam_look_at.x, shop->cam_look_at.y, shop->cam_look_at.z, 1000, CAMERA_CUT);
-				
-					SelectTextDraw(playerid, 0xD2B567FF);
-
-					PlayerPlaySound(playerid, 1145, 0.0, 0.0, 0.0);
-
-					shop_manager->_player_data[playerid].selected_item = shop->_shop_items.begin();
-					shop_manager->_player_data[playerid].object = CreatePlayerObject(playerid, shop_item->model, shop->object_pos.start.x, shop->object_pos.start.y, shop->object_pos.start.z, shop_item->rotation.x, shop_item->rotation.y, shop_item->rotation.z, 0.f);
-					MovePlayerObject(playerid, shop_manager->_player_data[playerid].object, shop->object_pos.idle.x, shop->object_pos.idle.y, shop->object_pos.idle.z, 1.2, -1000.0, -1000.0, -1000.0);
-				}
-			}
+			player->Flags().set(player::flags::can_use_shop_buttons, true);
+			player->Flags().set(player::flags::using_shop, true);
+
+			auto& shop = shop_manager->_shops[zone->id];
+			player->CurrentShop() = shop.get();
+
+			auto* textdraws = textdraw_manager["shop"];
+			auto& shop_item = shop->_shop_items.front();
+
+			textdraws->GetPlayerTextDraws(player)[0]->SetText(shop->name);
+			textdraws->GetPlayerTextDraws(player)[1]->SetText(fmt::format("${}", shop_item->price));
+			textdraws->GetPlayerTextDraws(player)[2]->SetText(shop_item->name);
+			textdraws->Show(player);
+
+			glm::vec3 cam_pos, cam_vec;
+			GetPlayerCameraPos(playerid, &cam_pos.x, &cam_pos.y, &cam_pos.z);
+			GetPlayerCameraFrontVector(playerid, &cam_vec.x, &cam_vec.y, &cam_vec.z);
+			InterpolateCameraPos(playerid, cam_pos.x, cam_pos.y, cam_pos.z, shop->cam_pos.x, shop->cam_pos.y, shop->cam_pos.z, 1000, CAMERA_CUT);
+			InterpolateCameraLookAt(playerid, cam_vec.x, cam_vec.y, cam_vec.z, shop->cam_look_at.x, shop->cam_look_at.y, shop->cam_look_at.z, 1000, CAMERA_CUT);
+
+			SelectTextDraw(playerid, 0xD2B567FF);
+
+			PlayerPlaySound(playerid, 1145, 0.0, 0.0, 0.0);
+
+			shop_manager->_player_data[playerid].selected_item = shop->_shop_items.begin();
+			shop_manager->_player_data[playerid].object = CreatePlayerObject(playerid, shop_item->model, shop->object_pos.start.x, shop->object_pos.start.y, shop->object_pos.start.z, shop_item->rotation.x, shop_item->rotation.y, shop_item->rotation.z, 0.f);
+			MovePlayerObject(playerid, shop_manager->_player_data[playerid].object, shop->object_pos.idle.x, shop->object_pos.idle.y, shop->object_pos.idle.z, 1.2, -1000.0, -1000.0, -1000.0);
 		}
 	}
 
@@ -123,7 +111,7 @@ static CPublicHook<shops::OnPlayerKeyStateChange> _s_opksc("OnPlayerKeyStateChan
 
 static cell RegisterShopCallbacks()
 {
-	auto* textdraws = textdraw_manager.LoadFile("shop.toml", "shop");
+	auto* textdraws = textdraw_manager["shop"];
 	// Left button
 	textdraws->GetGlobalTextDraws()[6]->SetCallback([](CPlayer* player) {
 		if (!player->Flags().test(player::flags::can_use_shop_buttons))
@@ -27,7 +27,7 @@ namespace shops
 		friend class CShopManager;
 
 		int label;
-		int area;
+		std::uint32_t zone;
 
 		std::string name;
 		glm::vec3 position;
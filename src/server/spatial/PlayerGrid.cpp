@@ -0,0 +1,116 @@
+#include "../../main.hpp"
+
+server::spatial::CPlayerGrid server::spatial::player_grid{};
+
+void server::spatial::CPlayerGrid::Link(std::uint16_t playerid, std::uint64_t key)
+{
+	auto& player = _players[playerid];
+	player.key = key;
+	player.tracked = true;
+	_cells[key].push_back(playerid);
+}
+
+void server::spatial::CPlayerGrid::Unlink(std::uint16_t playerid)
+{
+	auto& player = _players[playerid];
+	if (!player.tracked)
+		return;
+
+	auto it = _cells.find(player.key);
+	if (it != _cells.end())
+	{
+		auto& ids = it->second;
+		auto pos = std::find(ids.begin(), ids.end(), playerid);
+		if (pos != ids.end())
+		{
+			*pos = ids.back();
+			ids.pop_back();
+		}
+
+		if (ids.empty())
+			_cells.erase(it);
+	}
+
+	player.tracked = false;
+}
+
+void server::spatial::CPlayerGrid::Update(std::uint16_t playerid, const glm::vec3& position)
+{
+	if (playerid >= MAX_PLAYERS)
+		return;
+
+	auto& player = _players[playerid];
+	player.position = position;
+
+	const auto x = CellCoord(position.x), y = CellCoord(position.y);
+	if (!player.tracked || player.key != CellKey(player.world, player.interior, x, y))
+	{
+		Unlink(playerid);
+		player.world = GetPlayerVirtualWorld(playerid);
+		player.interior = GetPlayerInterior(playerid);
+		Link(playerid, CellKey(player.world, player.interior, x, y));
+	}
+
+	zones.Update(playerid, player.world, player.interior, position);
+}
+
+void server::spatial::CPlayerGrid::Refresh(std::uint16_t playerid, const glm::vec3& position)
+{
+	if (playerid >= MAX_PLAYERS)
+		return;
+
+	Unlink(playerid);
+	Update(playerid, position);
+}
+
+void server::spatial::CPlayerGrid::Refresh(std::uint16_t playerid)
+{
+	if (!Tracked(playerid))
+		return;
+
+	Refresh(playerid, _players[playerid].position);
+}
+
+void server::spatial::CPlayerGrid::Remove(std::uint16_t playerid)
+{
+	if (playerid >= MAX_PLAYERS)
+		return;
+
+	Unlink(playerid);
+	_players[playerid] = entry{};
+	zones.Remove(playerid);
+}
+
+std::vector<std::uint16_t> server::spatial::CPlayerGrid::QueryRadius(int world, int interior, const glm::vec3& center, float radius) const
+{
+	std::vector<std::uint16_t> result;
+	ForEachInRadius(world, interior, center, radius, [&result](std::uint16_t playerid, float /*distance*/) {
+		result.push_back(playerid);
+	});
+
+	return result;
+}
+
+std::vector<std::uint16_t> server::spatial::CPlayerGrid::QueryBox(int world, int interior, const glm::vec3& min, const glm::vec3& max) const
+{
+	std::vector<std::uint16_t> result;
+
+	for (auto x = CellCoord(min.x), max_x = CellCoord(max.x); x <= max_x; ++x)
+	{
+		for (auto y = CellCoord(min.y), max_y = CellCoord(max.y); y <= max_y; ++y)
+		{
+			auto it = _cells.find(CellKey(world, interior, x, y));
+			if (it == _cells.end())
+				continue;
+
+			for (auto playerid : it->second)
+			{
+				const auto& pos = _players[playerid].position;
+				if (glm::all(glm::greaterThanEqual(pos, min)) && glm::all(glm::lessThanEqual(pos, max)))
+					result.push_back(playerid);
+			}
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+namespace server::spatial
+{
+	constexpr float CELL_SIZE = 50.f;
+
+	inline std::int32_t CellCoord(float value)
+	{
+		return static_cast<std::int32_t>(std::floor(value / CELL_SIZE));
+	}
+
+	inline std::uint64_t CellKey(int world, int interior, std::int32_t x, std::int32_t y)
+	{
+		// 24 bits of world, 8 of interior and 16 per axis cover the whole map in every world we use
+		return (static_cast<std::uint64_t>(world & 0xFFFFFF) << 40) | (static_cast<std::uint64_t>(interior & 0xFF) << 32) |
+			(static_cast<std::uint64_t>(static_cast<std::uint16_t>(x)) << 16) | static_cast<std::uint64_t>(static_cast<std::uint16_t>(y));
+	}
+
+	// Uniform grid over player positions, bucketed by virtual world, interior and cell. Every update is also
+	// forwarded to the zone index.
+	// Positions come from the sync packets; worlds and interiors are re-read from the server only when
+	// a player crosses into another cell or Refresh() is called, so every SetPlayerVirtualWorld and
+	// SetPlayerInterior must be followed by a Refresh().
+	class CPlayerGrid
+	{
+		struct entry
+		{
+			bool tracked{ false };
+			std::uint64_t key{ 0u };
+			int world{ 0 };
+			int interior{ 0 };
+			glm::vec3 position{ 0.f };
+		};
+
+		std::array<entry, MAX_PLAYERS> _players{};
+		robin_hood::unordered_map<std::uint64_t, std::vector<std::uint16_t>> _cells;
+
+		void Link(std::uint16_t playerid, std::uint64_t key);
+		void Unlink(std::uint16_t playerid);
+
+	public:
+		CPlayerGrid() = default;
+		~CPlayerGrid() = default;
+
+		void Update(std::uint16_t playerid, const glm::vec3& position);
+		// Re-reads the world and interior of the player, call it right after teleporting it or changing any of them
+		void Refresh(std::uint16_t playerid, const glm::vec3& position);
+		// Same, keeping the last known position. Players that aren't tracked yet are left alone, their first
+		// sync packet reads the world and interior anyway
+		void Refresh(std::uint16_t playerid);
+		void Remove(std::uint16_t playerid);
+
+		// Calls `fn(playerid, distance)` for every player within `radius` of `center`
+		template<class F>
+		void ForEachInRadius(int world, int interior, const glm::vec3& center, float radius, F&& fn) const
+		{
+			const auto min_x = CellCoord(center.x - radius), max_x = CellCoord(center.x + radius);
+			const auto min_y = CellCoord(center.y - radius), max_y = CellCoord(center.y + radius);
+			const float radius_sq = radius * radius;
+
+			for (auto x = min_x; x <= max_x; ++x)
+			{
+				for (auto y = min_y; y <= max_y; ++y)
+				{
+					auto it = _cells.find(CellKey(world, interior, x, y));
+					if (it == _cells.end())
+						continue;
+
+					for (auto playerid : it->second)
+					{
+						const auto offset = _players[playerid].position - center;
+						const float distance_sq = glm::dot(offset, offset);
+						if (distance_sq <= radius_sq)
+							fn(playerid, std::sqrt(distance_sq));
+					}
+				}
+			}
+		}
+
+		std::vector<std::uint16_t> QueryRadius(int world, int interior, const glm::vec3& center, float radius) const;
+		std::vector<std::uint16_t> QueryBox(int world, int interior, const glm::vec3& min, const glm::vec3& max) const;
+
+		inline bool Tracked(std::uint16_t playerid) const { return playerid < MAX_PLAYERS && _players[playerid].tracked; }
+		inline const glm::vec3& Position(std::uint16_t playerid) const { return _players[playerid].position; }
+		inline int World(std::uint16_t playerid) const { return _players[playerid].world; }
+		inline int Interior(std::uint16_t playerid) const { return _players[playerid].interior; }
+	};
+
+	extern CPlayerGrid player_grid;
+}
@@ -0,0 +1,183 @@
+#include "../../main.hpp"
+
+server::spatial::CZoneManager server::spatial::zones{};
+
+bool server::spatial::CZoneManager::Contains(const zone_shape& shape, const glm::vec2& point)
+{
+	return std::visit([&point](auto&& area) -> bool {
+		using T = std::decay_t<decltype(area)>;
+
+		if constexpr (std::is_same_v<T, circle>)
+		{
+			const auto offset = point - area.center;
+			return glm::dot(offset, offset) <= area.radius * area.radius;
+		}
+		else if constexpr (std::is_same_v<T, rectangle>)
+		{
+			return point.x >= area.min.x && point.x <= area.max.x && point.y >= area.min.y && point.y <= area.max.y;
+		}
+		else
+		{
+			// Even-odd rule
+			bool inside = false;
+			const auto& pts = area.points;
+			for (std::size_t i = 0, j = pts.size() - 1; i < pts.size(); j = i++)
+			{
+				if (((pts[i].y > point.y) != (pts[j].y > point.y)) &&
+					(point.x < (pts[j].x - pts[i].x) * (point.y - pts[i].y) / (pts[j].y - pts[i].y) + pts[i].x))
+				{
+					inside = !inside;
+				}
+			}
+
+			return inside;
+		}
+	}, shape);
+}
+
+std::pair<glm::vec2, glm::vec2> server::spatial::CZoneManager::Bounds(const zone_shape& shape)
+{
+	return std::visit([](auto&& area) -> std::pair<glm::vec2, glm::vec2> {
+		using T = std::decay_t<decltype(area)>;
+
+		if constexpr (std::is_same_v<T, circle>)
+		{
+			return { area.center - area.radius, area.center + area.radius };
+		}
+		else if constexpr (std::is_same_v<T, rectangle>)
+		{
+			return { glm::min(area.min, area.max), glm::max(area.min, area.max) };
+		}
+		else
+		{
+			glm::vec2 min{ std::numeric_limits<float>::max() }, max{ std::numeric_limits<float>::lowest() };
+			for (auto&& point : area.points)
+			{
+				min = glm::min(min, point);
+				max = glm::max(max, point);
+			}
+
+			return { min, max };
+		}
+	}, shape);
+}
+
+std::uint32_t server::spatial::CZoneManager::Create(zone_shape shape, int world, int interior, zone_payload payload)
+{
+	if (auto* area = std::get_if<polygon>(&shape); area && area->points.size() < 3)
+	{
+		throw std::invalid_argument{ "a polygon zone needs at least 3 points" };
+	}
+
+	const auto id = static_cast<std::uint32_t>(_zones.size());
+	const auto [min, max] = Bounds(shape);
+
+	for (auto x = CellCoord(min.x), max_x = CellCoord(max.x); x <= max_x; ++x)
+	{
+		for (auto y = CellCoord(min.y), max_y = CellCoord(max.y); y <= max_y; ++y)
+		{
+			_cells[CellKey(world, interior, x, y)].push_back(id);
+		}
+	}
+
+	_zones.push_back({ std::move(shape), world, interior, payload });
+	return id;
+}
+
+void server::spatial::CZoneManager::OnEnter(zone_type type, zone_callback callback)
+{
+	_on_enter[static_cast<std::size_t>(type)].push_back(std::move(callback));
+}
+
+void server::spatial::CZoneManager::OnLeave(zone_type type, zone_callback callback)
+{
+	_on_leave[static_cast<std::size_t>(type)].push_back(std::move(callback));
+}
+
+void server::spatial::CZoneManager::Update(std::uint16_t playerid, int world, int interior, const glm::vec3& position)
+{
+	if (playerid >= MAX_PLAYERS)
+		return;
+
+	const glm::vec2 point{ position.x, position.y };
+	auto& inside = _inside[playerid];
+
+	// Most sync packets don't change anything, so the zones are collected in a buffer that keeps its capacity
+	// and only copied out when they differ
+	_candidates.clear();
+
+	auto it = _cells.find(CellKey(world, interior, CellCoord(point.x), CellCoord(point.y)));
+	if (it != _cells.end())
+	{
+		for (auto id : it->second)
+		{
+			if (Contains(_zones[id].shape, point))
+				_candidates.push_back(id);
+		}
+	}
+
+	if (_candidates == inside)
+		return;
+
+	// The callbacks may update other players, which reuses the buffer
+	const auto now = _candidates;
+
+	for (auto id : inside)
+	{
+		if (std::find(now.begin(), now.end(), id) == now.end())
+		{
+			const auto& payload = _zones[id].payload;
+			for (auto&& callback : _on_leave[static_cast<std::size_t>(payload.type)])
+				callback(playerid, payload);
+		}
+	}
+
+	for (auto id : now)
+	{
+		if (std::find(inside.begin(), inside.end(), id) == inside.end())
+		{
+			const auto& payload = _zones[id].payload;
+			for (auto&& callback : _on_enter[static_cast<std::size_t>(payload.type)])
+				callback(playerid, payload);
+		}
+	}
+
+	inside = now;
+}
+
+void server::spatial::CZoneManager::Remove(std::uint16_t playerid)
+{
+	if (playerid < MAX_PLAYERS)
+		_inside[playerid].clear();
+}
+
+std::optional<server::spatial::zone_payload> server::spatial::CZoneManager::Find(std::uint16_t playerid, zone_type type) const
+{
+	if (playerid >= MAX_PLAYERS)
+		return std::nullopt;
+
+	for (auto id : _inside[playerid])
+	{
+		if (_zones[id].payload.type == type)
+			return _zones[id].payload;
+	}
+
+	return std::nullopt;
+}
+
+std::vector<server::spatial::zone_payload> server::spatial::CZoneManager::At(int world, int interior, const glm::vec2& point) const
+{
+	std::vector<zone_payload> result;
+
+	auto it = _cells.find(CellKey(world, interior, CellCoord(point.x), CellCoord(point.y)));
+	if (it != _cells.end())
+	{
+		for (auto id : it->second)
+		{
+			if (Contains(_zones[id].shape, point))
+				result.push_back(_zones[id].payload);
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+namespace server::spatial
+{
+	enum class zone_type : std::uint8_t
+	{
+		enter_exit,
+		shop,
+		job,
+
+		max_zone_types
+	};
+
+	// What a zone stands for, interpreted by whoever registered it
+	struct zone_payload
+	{
+		zone_type type;
+		std::int32_t id{ 0 };
+		std::int32_t data{ 0 };
+	};
+
+	struct circle
+	{
+		glm::vec2 center;
+		float radius;
+	};
+
+	struct rectangle
+	{
+		glm::vec2 min;
+		glm::vec2 max;
+	};
+
+	struct polygon
+	{
+		std::vector<glm::vec2> points;
+	};
+
+	using zone_shape = std::variant<circle, rectangle, polygon>;
+
+	// Static 2D zones indexed on the same cells as the player grid. Zone membership of every player is
+	// recomputed from the sync position stream, so lookups on key presses never leave the plugin.
+	class CZoneManager
+	{
+	public:
+		using zone_callback = std::function<void(std::uint16_t playerid, const zone_payload&)>;
+
+	private:
+		struct zone
+		{
+			zone_shape shape;
+			int world;
+			int interior;
+			zone_payload payload;
+		};
+
+		std::vector<zone> _zones;
+		robin_hood::unordered_map<std::uint64_t, std::vector<std::uint32_t>> _cells;
+		std::array<std::vector<std::uint32_t>, MAX_PLAYERS> _inside;
+		std::vector<std::uint32_t> _candidates;
+		std::array<std::vector<zone_callback>, static_cast<std::size_t>(zone_type::max_zone_types)> _on_enter;
+		std::array<std::vector<zone_callback>, static_cast<std::size_t>(zone_type::max_zone_types)> _on_leave;
+
+		static bool Contains(const zone_shape& shape, const glm::vec2& point);
+		static std::pair<glm::vec2, glm::vec2> Bounds(const zone_shape& shape);
+
+	public:
+		CZoneManager() = default;
+		~CZoneManager() = default;
+
+		std::uint32_t Create(zone_shape shape, int world, int interior, zone_payload payload);
+
+		void OnEnter(zone_type type, zone_callback callback);
+		void OnLeave(zone_type type, zone_callback callback);
+
+		// Recomputes the zones the player is in and fires the enter/leave callbacks
+		void Update(std::uint16_t playerid, int world, int interior, const glm::vec3& position);
+		void Remove(std::uint16_t playerid);
+
+		// First zone of the given type the player is currently in
+		std::optional<zone_payload> Find(std::uint16_t playerid, zone_type type) const;
+		// Zones at an arbitrary point, for anything that isn't a player
+		std::vector<zone_payload> At(int world, int interior, const glm::vec2& point) const;
+	};
+
+	extern CZoneManager zones;
+}
@@ -26,7 +26,7 @@ int server::textdraw::GetTextDrawStringWidth(const std::string& string, std::uin
 	size_t other, result, width;
 	other = result = width = 0;
 
-	for (size_t i, length = string.length(); i < length; ++i) {
+	for (size_t i = 0, length = string.length(); i < length; ++i) {
 		if (string[i] == '~') {
 			if ((other = string.find('~', i + 1)) == std::string::npos) {
 				return GetTextDrawLineWidth("Error: unmatched tilde", font, outline, proportional);
@@ -154,25 +154,151 @@ cell server::textdraw::OnPlayerClickTextDraw(std::uint16_t playerid, std::uint16
 
 	auto* player = server::player_pool[playerid];
 	
-	if (player->TextDraws()._slots.test(clickedid))
+	auto* td = player->TextDraws().Owner(clickedid);
+	if (td && td->_data.callback)
 	{
-		auto it = std::find_if(player->TextDraws()._ids.begin(), player->TextDraws()._ids.end(), [clickedid](const auto& p) {
-			return p.second == clickedid;
-		});
+		td->_data.callback(player);
+	}
+
+	return 1;
+}
+
+static CPublicHook<server::textdraw::OnPlayerClickTextDraw> _td_cb_opctd("OnPlayerClickTextDraw");
+
+server::BaseTextDraw::~BaseTextDraw()
+{
+	if (_queued)
+		std::erase(_pending, this);
+}
+
+void server::BaseTextDraw::MarkDirty(property field)
+{
+	_payload.clear();
+	_dirty |= (1u << static_cast<std::uint8_t>(field));
+	if (!_frame)
+		_dirty_final = true;
+
+	if (!_coalesce)
+	{
+		Flush();
+		return;
+	}
+
+	if (!_queued)
+	{
+		_queued = true;
+		_pending.push_back(this);
+	}
+}
+
+void server::BaseTextDraw::ClearDirty()
+{
+	_dirty = 0u;
+	_dirty_final = false;
+}
+
+void server::BaseTextDraw::Flush()
+{
+	if (!_dirty)
+		return;
+
+	// Animated textdraws only ever send full shows, see ToggleAnimated
+	if (!_animated && _dirty == (1u << static_cast<std::uint8_t>(property::text)))
+		UpdateText();
+	else
+		Update();
+
+	ClearDirty();
+}
+
+const std::vector<unsigned char>& server::BaseTextDraw::Payload()
+{
+	if (_payload.empty())
+	{
+		net::OutStream payload;
+		std::uint8_t flags = _data.box;
 
-		if (it != player->TextDraws()._ids.end())
+		if (_data.proportional)
+		{
+			flags |= (1 << 4);
+		}
+
+		switch (_data.alignment)
 		{
-			if (it->first->_data.callback)
+			case 1:
+			{
+				flags |= (1 << 1);
+				break;
+			}
+			default:
+			case 2:
+			{
+				flags |= (1 << 3);
+				break;
+			}
+			case 3:
 			{
-				it->first->_data.callback(player);
+				flags |= (1 << 2);
+				break;
 			}
 		}
+
+		payload.Write<uint8_t>(flags);
+		payload.Write<float>(_data.letter_size.first);
+		payload.Write<float>(_data.letter_size.second);
+		payload.Write<uint32_t>((((_data.letter_color << 16) | _data.letter_color & 0xFF00) << 8) | (((_data.letter_color >> 16) | _data.letter_color & 0xFF0000) >> 8));
+		payload.Write<float>(_data.line_size.first);
+		payload.Write<float>(_data.line_size.second);
+		payload.Write<uint32_t>((((_data.box_color << 16) | _data.box_color & 0xFF00) << 8) | (((_data.box_color >> 16) | _data.box_color & 0xFF0000) >> 8));
+		payload.Write<uint8_t>(_data.shadow);
+		payload.Write<uint8_t>(_data.outline);
+		payload.Write<uint32_t>((((_data.background_color << 16) | _data.background_color & 0xFF00) << 8) | (((_data.background_color >> 16) | _data.background_color & 0xFF0000) >> 8));
+		payload.Write<uint8_t>(_data.style);
+		payload.Write<uint8_t>(_data.selectable);
+		payload.Write<float>(_data.position.first);
+		payload.Write<float>(_data.position.second);
+		payload.Write<uint16_t>(_data.modelid);
+		payload.Write<float>(_data.rotation.x);
+		payload.Write<float>(_data.rotation.y);
+		payload.Write<float>(_data.rotation.z);
+		payload.Write<float>(_data.zoom);
+		payload.Write<uint16_t>(_data.preview_colors.first);
+		payload.Write<uint16_t>(_data.preview_colors.second);
+		payload.Write<uint16_t>(_data.text.size());
+		payload.Write(_data.text.c_str(), _data.text.size());
+
+		_payload.assign(payload.GetData(), payload.GetData() + payload.GetNumberOfBytesUsed());
 	}
 
-	return 1;
+	return _payload;
 }
 
-static CPublicHook<server::textdraw::OnPlayerClickTextDraw> _td_cb_opctd("OnPlayerClickTextDraw");
+void server::BaseTextDraw::WritePayload(BitStream& bs)
+{
+	const auto& payload = Payload();
+	bs.Write(reinterpret_cast<const char*>(payload.data()), static_cast<unsigned int>(payload.size()));
+}
+
+void server::BaseTextDraw::WritePayload(BitStream& bs, std::string_view text)
+{
+	// The string is always the last thing in the payload
+	const auto& payload = Payload();
+	bs.Write(reinterpret_cast<const char*>(payload.data()), static_cast<unsigned int>(payload.size() - sizeof(std::uint16_t) - _data.text.size()));
+	bs.Write<uint16_t>(text.size());
+	bs.Write(text.data(), text.size());
+}
+
+void server::BaseTextDraw::FlushAll()
+{
+	// Flushing never marks anything dirty, so the list can't change while it's walked
+	for (auto* textdraw : _pending)
+	{
+		textdraw->_queued = false;
+		textdraw->Flush();
+	}
+
+	_pending.clear();
+}
 
 server::TextDraw::~TextDraw()
 {
@@ -186,11 +312,12 @@ void server::TextDraw::PushState()
 
 void server::TextDraw::PopState()
 {
-	if (!_states.empty())
+	if (_states.empty())
 		return;
 
 	_data = std::move(_states.top());
 	_states.pop();
+	_payload.clear();
 }
 
 void server::TextDraw::Show(CPlayer* player)
@@ -207,180 +334,116 @@ void server::TextDraw::Show()
 {
 	for (auto&& [id, player] : server::player_pool)
 	{
-		Show(player.get());
+		if (player->TextDraws()[this] != 0xFFFF)
+		{
+			_shown_for.set(id, true);
+		}
 	}
+
+	Update();
+	ClearDirty();
 }
 
 void server::TextDraw::Hide(CPlayer* player)
 {
 	if (_shown_for.test(player->PlayerId()))
 	{
-		BitStream bs;
-		bs.Write<std::uint16_t>(player->TextDraws()[this]);
-		net::RakServer->SendRPC(&bs, net::raknet::RPC_TextDrawHideForPlayer, player->PlayerId(), HIGH_PRIORITY, RELIABLE);
+		net::OutStream bs;
+		bs.Write<std::uint16_t>(player->TextDraws().Lookup(this));
+		net::rpc_queue.Push(&bs, net::raknet::RPC_TextDrawHideForPlayer, player->PlayerId(), (_animated ? net::message_class::hud_final : net::message_class::hud_state));
 		player->TextDraws().FreeId(this);
 
 		_shown_for.set(player->PlayerId(), false);
 	}
+
+	_text_overrides.erase(player->PlayerId());
 }
 
 void server::TextDraw::Hide()
 {
+	if (_shown_for.none())
+		return;
+
+	net::OutStream bs;
+	bs.Write<std::uint16_t>(0U);
+	net::Multicast{ &bs, net::raknet::RPC_TextDrawHideForPlayer, (_animated ? net::message_class::hud_final : net::message_class::hud_state) }
+		.Patch(0, sizeof(std::uint16_t), [this](std::uint16_t playerid) -> std::uint32_t { return server::player_pool[playerid]->TextDraws().Lookup(this); })
+		.Send(_shown_for);
+
 	for (std::uint16_t bit = 0U; bit < _shown_for.size(); ++bit)
 	{
 		if (_shown_for[bit])
 		{
-			BitStream bs;
-			bs.Write<std::uint16_t>(server::player_pool[bit]->TextDraws()[this]);
-			net::RakServer->SendRPC(&bs, net::raknet::RPC_TextDrawHideForPlayer, server::player_pool[bit]->PlayerId(), HIGH_PRIORITY, RELIABLE);
 			server::player_pool[bit]->TextDraws().FreeId(this);
 		}
 	}
 
 	_shown_for.reset();
+	_text_overrides.clear();
+	// Whatever changed is sent with the next show
+	ClearDirty();
 }
 
 server::TextDraw* server::TextDraw::SetText(std::string text)
 {
-	_data.text = std::move(text);
-	std::for_each(_data.text.begin(), _data.text.end(), [](char& c) {
-		switch (c)
-		{
-			case '': c = (char)151; break;
-			case '': c = (char)152; break;
-			case '': c = (char)153; break;
-			case '': c = (char)154; break;
-			case '': c = (char)128; break;
-			case '': c = (char)129; break;
-			case '': c = (char)130; break;
-			case '': c = (char)131; break;
-			case '': c = (char)157; break;
-			case '': c = (char)158; break;
-			case '': c = (char)159; break;
-			case '': c = (char)160; break;
-			case '': c = (char)134; break;
-			case '': c = (char)135; break;
-			case '': c = (char)136; break;
-			case '': c = (char)137; break;
-			case '': c = (char)161; break;
-			case '': c = (char)162; break;
-			case '': c = (char)163; break;
-			case '': c = (char)164; break;
-			case '': c = (char)138; break;
-			case '': c = (char)139; break;
-			case '': c = (char)140; break;
-			case '': c = (char)141; break;
-			case '': c = (char)165; break;
-			case '': c = (char)166; break;
-			case '': c = (char)167; break;
-			case '': c = (char)168; break;
-			case '': c = (char)142; break;
-			case '': c = (char)143; break;
-			case '': c = (char)144; break;
-			case '': c = (char)145; break;
-			case '': c = (char)169; break;
-			case '': c = (char)170; break;
-			case '': c = (char)171; break;
-			case '': c = (char)172; break;
-			case '': c = (char)146; break;
-			case '': c = (char)147; break;
-			case '': c = (char)148; break;
-			case '': c = (char)149; break;
-			case '': c = (char)174; break;
-			case '': c = (char)173; break;
-			case '': c = (char)64; break;
-			case '': c = (char)175; break;
-			case '`': c = (char)177; break;
-		}
-	});
+	textdraw::EncodeGtaText(text);
+
+	if (_data.text != text)
+	{
+		_data.text = std::move(text);
+		MarkDirty(property::text);
+	}
+
+	return this;
+}
 
+void server::TextDraw::UpdateText()
+{
 	if (_shown_for.any())
 	{
-		BitStream bs;
+		// Players with their own text don't see this change
+		auto targets = _shown_for;
+		for (auto&& [playerid, text] : _text_overrides)
+			targets.reset(playerid);
+
+		if (targets.none())
+			return;
+
+		net::OutStream bs;
 		bs.Write<uint16_t>(0U);
 		bs.Write<uint16_t>(_data.text.size());
 		bs.Write(_data.text.c_str(), _data.text.size());
 
-		for (uint16_t bit = 0U; bit < _shown_for.size(); ++bit)
-		{
-			if (_shown_for[bit])
-			{
-				bs.SetWriteOffset(0);
-				bs.Write<uint16_t>(server::player_pool[bit]->TextDraws()[this]);
-				net::RakServer->SendRPC(&bs, net::raknet::RPC_TextDrawSetString, bit, HIGH_PRIORITY, RELIABLE, 0);
-			}
-		}
+		net::Multicast{ &bs, net::raknet::RPC_TextDrawSetString, net::message_class::hud_state }
+			.Patch(0, sizeof(std::uint16_t), [this](std::uint16_t playerid) -> std::uint32_t { return server::player_pool[playerid]->TextDraws().Lookup(this); })
+			.Send(targets);
 	}
-
-	return this;
 }
 
 void server::TextDraw::Update()
 {
 	if (_shown_for.any())
 	{
-		std::uint8_t flags = _data.box;
-
-		if (_data.proportional)
-		{
-			flags |= (1 << 4);
-		}
-
-		switch (_data.alignment)
+		auto targets = _shown_for;
+		for (auto&& [playerid, text] : _text_overrides)
 		{
-			case 1:
-			{
-				flags |= (1 << 1);
-				break;
-			}
-			default:
-			case 2:
-			{
-				flags |= (1 << 3);
-				break;
-			}
-			case 3:
+			if (targets.test(playerid))
 			{
-				flags |= (1 << 2);
-				break;
+				targets.reset(playerid);
+				Update(server::player_pool[playerid]);
 			}
 		}
 
-		BitStream bs;
+		if (targets.none())
+			return;
+
+		net::OutStream bs;
 		bs.Write<uint16_t>(0);
-		bs.Write<uint8_t>(flags);
-		bs.Write<float>(_data.letter_size.first);
-		bs.Write<float>(_data.letter_size.second);
-		bs.Write<uint32_t>((((_data.letter_color << 16) | _data.letter_color & 0xFF00) << 8) | (((_data.letter_color >> 16) | _data.letter_color & 0xFF0000) >> 8));
-		bs.Write<float>(_data.line_size.first);
-		bs.Write<float>(_data.line_size.second);
-		bs.Write<uint32_t>((((_data.box_color << 16) | _data.box_color & 0xFF00) << 8) | (((_data.box_color >> 16) | _data.box_color & 0xFF0000) >> 8));
-		bs.Write<uint8_t>(_data.shadow);
-		bs.Write<uint8_t>(_data.outline);
-		bs.Write<uint32_t>((((_data.background_color << 16) | _data.background_color & 0xFF00) << 8) | (((_data.background_color >> 16) | _data.background_color & 0xFF0000) >> 8));
-		bs.Write<uint8_t>(_data.style);
-		bs.Write<uint8_t>(_data.selectable);
-		bs.Write<float>(_data.position.first);
-		bs.Write<float>(_data.position.second);
-		bs.Write<uint16_t>(_data.modelid);
-		bs.Write<float>(_data.rotation.x);
-		bs.Write<float>(_data.rotation.y);
-		bs.Write<float>(_data.rotation.z);
-		bs.Write<float>(_data.zoom);
-		bs.Write<uint16_t>(_data.preview_colors.first);
-		bs.Write<uint16_t>(_data.preview_colors.second);
-		bs.Write<uint16_t>(_data.text.size());
-		bs.Write(_data.text.c_str(), _data.text.size());
+		WritePayload(bs);
 
-		for (uint16_t bit = 0U; bit < _shown_for.size(); ++bit)
-		{
-			if (_shown_for[bit])
-			{
-				bs.SetWriteOffset(0);
-				bs.Write<uint16_t>(server::player_pool[bit]->TextDraws()[this]);
-				net::RakServer->SendRPC(&bs, net::raknet::RPC_ShowTextDraw, bit, HIGH_PRIORITY, RELIABLE, 0);
-			}
-		}
+		net::Multicast{ &bs, net::raknet::RPC_ShowTextDraw, SendClass() }
+			.Patch(0, sizeof(std::uint16_t), [this](std::uint16_t playerid) -> std::uint32_t { return server::player_pool[playerid]->TextDraws().Lookup(this); })
+			.Send(targets);
 	}
 }
 
@@ -388,60 +451,50 @@ void server::TextDraw::Update(CPlayer* player)
 {
 	if (_shown_for.test(player->PlayerId()))
 	{
-		std::uint8_t flags = _data.box;
+		net::OutStream bs;
+		bs.Write<uint16_t>(player->TextDraws().Lookup(this));
 
-		if (_data.proportional)
-		{
-			flags |= (1 << 4);
-		}
+		if (auto it = _text_overrides.find(player->PlayerId()); it != _text_overrides.end())
+			WritePayload(bs, it->second);
+		else
+			WritePayload(bs);
 
-		switch (_data.alignment)
-		{
-			case 1:
-			{
-				flags |= (1 << 1);
-				break;
-			}
-			default:
-			case 2:
-			{
-				flags |= (1 << 3);
-				break;
-			}
-			case 3:
-			{
-				flags |= (1 << 2);
-				break;
-			}
-		}
+		net::rpc_queue.Push(&bs, net::raknet::RPC_ShowTextDraw, player->PlayerId(), SendClass());
+	}
+}
 
-		BitStream bs;
-		bs.Write<uint16_t>(player->TextDraws()[this]);
-		bs.Write<uint8_t>(flags);
-		bs.Write<float>(_data.letter_size.first);
-		bs.Write<float>(_data.letter_size.second);
-		bs.Write<uint32_t>((((_data.letter_color << 16) | _data.letter_color & 0xFF00) << 8) | (((_data.letter_color >> 16) | _data.letter_color & 0xFF0000) >> 8));
-		bs.Write<float>(_data.line_size.first);
-		bs.Write<float>(_data.line_size.second);
-		bs.Write<uint32_t>((((_data.box_color << 16) | _data.box_color & 0xFF00) << 8) | (((_data.box_color >> 16) | _data.box_color & 0xFF0000) >> 8));
-		bs.Write<uint8_t>(_data.shadow);
-		bs.Write<uint8_t>(_data.outline);
-		bs.Write<uint32_t>((((_data.background_color << 16) | _data.background_color & 0xFF00) << 8) | (((_data.background_color >> 16) | _data.background_color & 0xFF0000) >> 8));
-		bs.Write<uint8_t>(_data.style);
-		bs.Write<uint8_t>(_data.selectable);
-		bs.Write<float>(_data.position.first);
-		bs.Write<float>(_data.position.second);
-		bs.Write<uint16_t>(_data.modelid);
-		bs.Write<float>(_data.rotation.x);
-		bs.Write<float>(_data.rotation.y);
-		bs.Write<float>(_data.rotation.z);
-		bs.Write<float>(_data.zoom);
-		bs.Write<uint16_t>(_data.preview_colors.first);
-		bs.Write<uint16_t>(_data.preview_colors.second);
-		bs.Write<uint16_t>(_data.text.size());
-		bs.Write(_data.text.c_str(), _data.text.size());
-		net::RakServer->SendRPC(&bs, net::raknet::RPC_ShowTextDraw, player->PlayerId(), HIGH_PRIORITY, RELIABLE, 0);
+void server::TextDraw::SendText(CPlayer* player, const std::string& text)
+{
+	if (_shown_for.test(player->PlayerId()))
+	{
+		net::OutStream bs;
+		bs.Write<uint16_t>(player->TextDraws().Lookup(this));
+		bs.Write<uint16_t>(text.size());
+		bs.Write(text.c_str(), text.size());
+		net::rpc_queue.Push(&bs, net::raknet::RPC_TextDrawSetString, player->PlayerId(), net::message_class::hud_state);
+	}
+}
+
+server::TextDraw* server::TextDraw::SetTextFor(CPlayer* player, std::string text)
+{
+	textdraw::EncodeGtaText(text);
+
+	auto& current = _text_overrides[player->PlayerId()];
+	if (current != text)
+	{
+		current = std::move(text);
+		SendText(player, current);
 	}
+
+	return this;
+}
+
+server::TextDraw* server::TextDraw::ResetTextFor(CPlayer* player)
+{
+	if (_text_overrides.erase(player->PlayerId()))
+		SendText(player, _data.text);
+
+	return this;
 }
 
 inline bool server::TextDraw::ShownFor(CPlayer* player) const
@@ -462,17 +515,19 @@ void server::PlayerTextDraw::Show()
 	}
 	
 	Update();
+	ClearDirty();
 }
 
 void server::PlayerTextDraw::Hide()
 {
 	if (Shown())
 	{
-		BitStream bs;
+		net::OutStream bs;
 		bs.Write<std::uint16_t>(_id);
-		net::RakServer->SendRPC(&bs, net::raknet::RPC_TextDrawHideForPlayer, _playerid, HIGH_PRIORITY, RELIABLE);
+		net::rpc_queue.Push(&bs, net::raknet::RPC_TextDrawHideForPlayer, _playerid, (_animated ? net::message_class::hud_final : net::message_class::hud_state));
 		server::player_pool[_playerid]->TextDraws().FreeId(this);
 		_id = 0xFFFF;
+		ClearDirty();
 	}
 }
 
@@ -480,125 +535,219 @@ void server::PlayerTextDraw::Update()
 {
 	if (Shown())
 	{
-		std::uint8_t flags = _data.box;
+		net::OutStream bs;
+		bs.Write<uint16_t>(_id);
+		WritePayload(bs);
+		net::rpc_queue.Push(&bs, net::raknet::RPC_ShowTextDraw, _playerid, SendClass());
+	}
+}
 
-		if (_data.proportional)
-		{
-			flags |= (1 << 4);
-		}
+server::PlayerTextDraw* server::PlayerTextDraw::SetText(std::string text)
+{
+	textdraw::EncodeGtaText(text);
 
-		switch (_data.alignment)
-		{
-			case 1:
-			{
-				flags |= (1 << 1);
-				break;
-			}
-			default:
-			case 2:
-			{
-				flags |= (1 << 3);
-				break;
-			}
-			case 3:
-			{
-				flags |= (1 << 2);
-				break;
-			}
-		}
+	if (_data.text != text)
+	{
+		_data.text = std::move(text);
+		MarkDirty(property::text);
+	}
+
+	return this;
+}
 
-		BitStream bs;
+void server::PlayerTextDraw::UpdateText()
+{
+	if (Shown())
+	{
+		net::OutStream bs;
 		bs.Write<uint16_t>(_id);
-		bs.Write<uint8_t>(flags);
-		bs.Write<float>(_data.letter_size.first);
-		bs.Write<float>(_data.letter_size.second);
-		bs.Write<uint32_t>((((_data.letter_color << 16) | _data.letter_color & 0xFF00) << 8) | (((_data.letter_color >> 16) | _data.letter_color & 0xFF0000) >> 8));
-		bs.Write<float>(_data.line_size.first);
-		bs.Write<float>(_data.line_size.second);
-		bs.Write<uint32_t>((((_data.box_color << 16) | _data.box_color & 0xFF00) << 8) | (((_data.box_color >> 16) | _data.box_color & 0xFF0000) >> 8));
-		bs.Write<uint8_t>(_data.shadow);
-		bs.Write<uint8_t>(_data.outline);
-		bs.Write<uint32_t>((((_data.background_color << 16) | _data.background_color & 0xFF00) << 8) | (((_data.background_color >> 16) | _data.background_color & 0xFF0000) >> 8));
-		bs.Write<uint8_t>(_data.style);
-		bs.Write<uint8_t>(_data.selectable);
-		bs.Write<float>(_data.position.first);
-		bs.Write<float>(_data.position.second);
-		bs.Write<uint16_t>(_data.modelid);
-		bs.Write<float>(_data.rotation.x);
-		bs.Write<float>(_data.rotation.y);
-		bs.Write<float>(_data.rotation.z);
-		bs.Write<float>(_data.zoom);
-		bs.Write<uint16_t>(_data.preview_colors.first);
-		bs.Write<uint16_t>(_data.preview_colors.second);
 		bs.Write<uint16_t>(_data.text.size());
 		bs.Write(_data.text.c_str(), _data.text.size());
-		net::RakServer->SendRPC(&bs, net::raknet::RPC_ShowTextDraw, _playerid, HIGH_PRIORITY, RELIABLE, 0);
+		net::rpc_queue.Push(&bs, net::raknet::RPC_TextDrawSetString, _playerid, net::message_class::hud_state);
 	}
 }
 
-server::PlayerTextDraw* server::PlayerTextDraw::SetText(std::string text)
+// Stand-in for a PlayerTextDraw that sends to a queue of its own, so /tdbench never touches the players' queues,
+// their textdraw IDs or anything they see
+class CBenchTextDraw final : public server::BaseTextDraw
 {
-	_data.text = std::move(text);
-	std::for_each(_data.text.begin(), _data.text.end(), [](char& c) {
-		switch (c)
-		{
-			case '': c = (char)151; break;
-			case '': c = (char)152; break;
-			case '': c = (char)153; break;
-			case '': c = (char)154; break;
-			case '': c = (char)128; break;
-			case '': c = (char)129; break;
-			case '': c = (char)130; break;
-			case '': c = (char)131; break;
-			case '': c = (char)157; break;
-			case '': c = (char)158; break;
-			case '': c = (char)159; break;
-			case '': c = (char)160; break;
-			case '': c = (char)134; break;
-			case '': c = (char)135; break;
-			case '': c = (char)136; break;
-			case '': c = (char)137; break;
-			case '': c = (char)161; break;
-			case '': c = (char)162; break;
-			case '': c = (char)163; break;
-			case '': c = (char)164; break;
-			case '': c = (char)138; break;
-			case '': c = (char)139; break;
-			case '': c = (char)140; break;
-			case '': c = (char)141; break;
-			case '': c = (char)165; break;
-			case '': c = (char)166; break;
-			case '': c = (char)167; break;
-			case '': c = (char)168; break;
-			case '': c = (char)142; break;
-			case '': c = (char)143; break;
-			case '': c = (char)144; break;
-			case '': c = (char)145; break;
-			case '': c = (char)169; break;
-			case '': c = (char)170; break;
-			case '': c = (char)171; break;
-			case '': c = (char)172; break;
-			case '': c = (char)146; break;
-			case '': c = (char)147; break;
-			case '': c = (char)148; break;
-			case '': c = (char)149; break;
-			case '': c = (char)174; break;
-			case '': c = (char)173; break;
-			case '': c = (char)64; break;
-			case '': c = (char)175; break;
-			case '`': c = (char)177; break;
-			case '&': c = (char)38; break;
-		}
-	});
+	net::CRpcQueue& _queue;
+	mutable std::uint16_t _id;
+	bool _shown{ false };
 
-	if (Shown())
+	void Update() override
 	{
-		BitStream bs;
-		bs.Write<uint16_t>(_id);
-		bs.Write<uint16_t>(_data.text.size());
+		if (!_shown)
+			return;
+
+		net::OutStream bs;
+		bs.Write<std::uint16_t>(_id);
+		WritePayload(bs);
+		_queue.Push(&bs, net::raknet::RPC_ShowTextDraw, 0, SendClass());
+	}
+
+	void UpdateText() override
+	{
+		if (!_shown)
+			return;
+
+		net::OutStream bs;
+		bs.Write<std::uint16_t>(_id);
+		bs.Write<std::uint16_t>(_data.text.size());
 		bs.Write(_data.text.c_str(), _data.text.size());
-		net::RakServer->SendRPC(&bs, net::raknet::RPC_TextDrawSetString, _playerid, HIGH_PRIORITY, RELIABLE, 0);
+		_queue.Push(&bs, net::raknet::RPC_TextDrawSetString, 0, net::message_class::hud_state);
 	}
 
-	return this;
-}
+	inline std::uint16_t& IdSlot(std::uint16_t) const override { return _id; }
+	inline bool PerPlayer() const override { return true; }
+	inline void Evict(CPlayer*) override {}
+
+public:
+	CBenchTextDraw(net::CRpcQueue& queue, std::uint16_t id)
+		: _queue(queue), _id(id)
+	{}
+
+	void Show()
+	{
+		_shown = true;
+		Update();
+		ClearDirty();
+	}
+
+	void Hide()
+	{
+		if (!_shown)
+			return;
+
+		net::OutStream bs;
+		bs.Write<std::uint16_t>(_id);
+		_queue.Push(&bs, net::raknet::RPC_TextDrawHideForPlayer, 0, (_animated ? net::message_class::hud_final : net::message_class::hud_state));
+		_shown = false;
+		ClearDirty();
+	}
+};
+
+static command tdbench_cmd("tdbench", command::make_flag<player::rank::admin>, [](CPlayer* player, cmd::argument_store args) {
+	int frames{ 60 };
+
+	try
+	{
+		if (!args.empty())
+			args >> frames;
+	}
+	catch (const std::exception& e)
+	{
+		player->Chat()->Send(0xDADADAFF, "USO: {ED2B2B}/tdbench{DADADA} [fotogramas]");
+		return;
+	}
+
+	frames = std::clamp(frames, 1, 1000);
+
+	using textdraw_set = std::vector<std::unique_ptr<CBenchTextDraw>>;
+
+	struct result
+	{
+		std::size_t pushed;
+		std::size_t sent;
+		std::chrono::microseconds time;
+	};
+
+	// Every run gets fresh textdraws and a queue nobody else uses, ending a tick only flushes those
+	auto measure = [](std::size_t count, const std::function<void(textdraw_set&, const std::function<void()>&)>& flow) -> result {
+		auto queue = std::make_unique<net::CRpcQueue>();
+		textdraw_set textdraws;
+		for (std::size_t i = 0; i < count; ++i)
+			textdraws.push_back(std::make_unique<CBenchTextDraw>(*queue, static_cast<std::uint16_t>(i)));
+
+		auto end_tick = [&] {
+			for (auto&& td : textdraws)
+				td->Flush();
+			queue->Drain();
+		};
+
+		const auto start = std::chrono::steady_clock::now();
+		flow(textdraws, end_tick);
+		end_tick();
+		const auto time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+		return { queue->PushedCount(), queue->SentCount(), time };
+	};
+
+	// Same calls as CNotificationManager::MoveLeft: five positions and a show per frame
+	auto notification_flow = [frames](textdraw_set& tds, const std::function<void()>& end_tick) {
+		for (auto&& td : tds)
+			td->Show();
+
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			for (std::size_t i = 0; i < tds.size(); ++i)
+				tds[i]->AsFrame()->SetPosition({ 108.f - (i * 20.f) - frame, 290.f });
+
+			for (auto&& td : tds)
+				td->Show();
+			end_tick();
+		}
+
+		for (auto&& td : tds)
+			td->Hide();
+	};
+
+	// Same calls as CNotificationManager::ProcessBeatingText: color and background per frame
+	auto beating_flow = [frames](textdraw_set& tds, const std::function<void()>& end_tick) {
+		auto& td = tds.front();
+		td->ToggleAnimated(true)->AsFrame(false)->SetText("benchmark");
+		td->Show();
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			const auto alpha = static_cast<std::uint32_t>(255 - (frame * 4) % 256);
+			td->AsFrame()->SetLetterColor(0xFFFFFF00 | alpha)->SetBackgroundColor(alpha);
+			end_tick();
+		}
+
+		td->Hide();
+	};
+
+	// SetHunger and SetThirst in the same tick, each one re-applies both bars like CNeedsManager::UpdateTextDraws
+	auto needs_flow = [frames](textdraw_set& bars, const std::function<void()>& end_tick) {
+		bars[0]->Show();
+		bars[1]->Show();
+
+		float thirst = 505.f;
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			const float hunger = 608.f - (frame % 100) * 0.975f;
+			bars[0]->SetLineSize({ hunger, 0.f });
+			bars[1]->SetLineSize({ thirst, 0.f });
+
+			thirst = 505.f + (frame % 100) * 0.915f;
+			bars[0]->SetLineSize({ hunger, 0.f });
+			bars[1]->SetLineSize({ thirst, 0.f });
+			end_tick();
+		}
+	};
+
+	struct flow_info
+	{
+		const char* name;
+		std::size_t textdraws;
+		std::function<void(textdraw_set&, const std::function<void()>&)> flow;
+	};
+
+	const flow_info flows[] = {
+		{ "Notificaciones", 5u, notification_flow },
+		{ "Texto parpadeante", 1u, beating_flow },
+		{ "Barras de necesidades", 2u, needs_flow }
+	};
+
+	player->Chat()->Send(0xDADADAFF, "RPCs de textdraws en {{ED2B2B}}{}{{DADADA}} fotogramas (inmediato / agrupado por tick):", frames);
+
+	for (auto&& [name, count, flow] : flows)
+	{
+		server::BaseTextDraw::ToggleCoalescing(false);
+		const auto immediate = measure(count, flow);
+		server::BaseTextDraw::ToggleCoalescing(true);
+		const auto coalesced = measure(count, flow);
+
+		player->Chat()->Send(0xDADADAFF, "{{ED2B2B}}{}{{DADADA}}: {} / {} generados, {} / {} enviados, {} / {} us", name, immediate.pushed, coalesced.pushed, immediate.sent, coalesced.sent, immediate.time.count(), coalesced.time.count());
+	}
+});
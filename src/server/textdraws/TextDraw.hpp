@@ -1,8 +1,8 @@
 #pragma once
 
-#define DEFINE_GETTER_SETTER(getter,setter,variable) \
+#define DEFINE_GETTER_SETTER(getter,setter,variable,field) \
 	inline auto getter() const { return variable; }\
-	auto* setter(decltype(variable) value) { variable = value; Update(); return this; }
+	auto* setter(decltype(variable) value) { if (variable != value) { variable = value; MarkDirty(property::field); } return this; }
 
 class CPlayer;
 
@@ -115,6 +115,40 @@ namespace server
 			 0,   0,   0,   0,   0,   0,   0,   0
 		};
 
+		// Textdraw fonts don't follow Latin-1, accented characters live at these positions instead.
+		// Chat, dialogs and 3D labels are drawn with regular Windows fonts and must not be remapped.
+		constexpr std::pair<char, std::uint8_t> GtaCharsetRemap[] = {
+			{ '', 151 }, { '', 152 }, { '', 153 }, { '', 154 },
+			{ '', 128 }, { '', 129 }, { '', 130 }, { '', 131 },
+			{ '', 157 }, { '', 158 }, { '', 159 }, { '', 160 },
+			{ '', 134 }, { '', 135 }, { '', 136 }, { '', 137 },
+			{ '', 161 }, { '', 162 }, { '', 163 }, { '', 164 },
+			{ '', 138 }, { '', 139 }, { '', 140 }, { '', 141 },
+			{ '', 165 }, { '', 166 }, { '', 167 }, { '', 168 },
+			{ '', 142 }, { '', 143 }, { '', 144 }, { '', 145 },
+			{ '', 169 }, { '', 170 }, { '', 171 }, { '', 172 },
+			{ '', 146 }, { '', 147 }, { '', 148 }, { '', 149 },
+			{ '', 174 }, { '', 173 }, { '', 64 }, { '', 175 },
+			{ '`', 177 }
+		};
+
+		constexpr auto GtaCharsetLUT = [] {
+			std::array<std::uint8_t, 256> lut{};
+			for (std::size_t i = 0; i < lut.size(); ++i)
+				lut[i] = static_cast<std::uint8_t>(i);
+
+			for (auto&& [from, to] : GtaCharsetRemap)
+				lut[static_cast<unsigned char>(from)] = to;
+
+			return lut;
+		}();
+
+		inline void EncodeGtaText(std::string& text)
+		{
+			for (auto& c : text)
+				c = static_cast<char>(GtaCharsetLUT[static_cast<unsigned char>(c)]);
+		}
+
 		std::uint8_t GetTextDrawCharacterWidth(std::uint8_t character, std::uint8_t font, bool proportional = true);
 		int GetTextDrawStringWidth(const std::string& string, std::uint8_t font, std::uint8_t outline = 0, bool proportional = true);
 		int GetTextDrawLineWidth(const std::string& string, std::uint8_t font, std::uint8_t outline = 0, bool proportional = true, int start = 0, int end = -1);
@@ -158,38 +192,118 @@ namespace server
 	class BaseTextDraw
 	{
 		friend cell server::textdraw::OnPlayerClickTextDraw(std::uint16_t playerid, std::uint16_t clickedid);
+		friend class TextDrawIndexManager;
 
 	protected:
+		enum class property : std::uint8_t
+		{
+			box,
+			alignment,
+			proportional,
+			letter_size,
+			letter_color,
+			line_size,
+			box_color,
+			shadow,
+			outline,
+			background_color,
+			font,
+			selectable,
+			position,
+			preview_model,
+			preview_rotation,
+			preview_zoom,
+			preview_colors,
+			text
+		};
+
 		stTextDrawData _data{};
+		bool _animated{ false };
+		bool _frame{ false };
+		textdraw_priority _priority{ textdraw_priority::hud };
+
+		// Properties changed since the last time the textdraw was sent, see Flush()
+		std::uint32_t _dirty{ 0u };
+		bool _dirty_final{ false };
+		bool _queued{ false };
 
+		// Serialized show RPC without the leading textdraw ID, rebuilt after any change
+		std::vector<unsigned char> _payload;
+
+		inline static std::vector<BaseTextDraw*> _pending;
+		inline static bool _coalesce{ true };
+
+		inline net::message_class SendClass() const
+		{
+			if (!_animated)
+				return net::message_class::hud_state;
+
+			// A coalesced change that wasn't a frame must not be sent as one
+			return (_frame && !_dirty_final ? net::message_class::hud_frame : net::message_class::hud_final);
+		}
+
+		void MarkDirty(property field);
+		void ClearDirty();
+		const std::vector<unsigned char>& Payload();
+		// Appends everything but the ID to a show RPC, the ID is the only part that differs between players
+		void WritePayload(BitStream& bs);
+		void WritePayload(BitStream& bs, std::string_view text);
+
+		// Sends the whole textdraw to everyone it's shown for
 		virtual void Update() = 0;
+		// Sends only the string, only used when nothing else changed
+		virtual void UpdateText() = 0;
+
+		// Where the ID given by the player's TextDrawIndexManager is kept
+		virtual std::uint16_t& IdSlot(std::uint16_t playerid) const = 0;
+		// Which of the player's budgets the ID counts against
+		virtual bool PerPlayer() const = 0;
+		// Hides the textdraw for this player to give its ID to something more important
+		virtual void Evict(CPlayer* player) = 0;
 	public:
-		virtual ~BaseTextDraw() = default;
+		virtual ~BaseTextDraw();
 	
-		DEFINE_GETTER_SETTER(UsingBox, ToggleBox, _data.box)
-		DEFINE_GETTER_SETTER(GetAlignment, SetAlignment, _data.alignment)
-		DEFINE_GETTER_SETTER(IsProportional, ToggleProportional, _data.proportional)
-		DEFINE_GETTER_SETTER(GetLetterSize, SetLetterSize, _data.letter_size)
-		DEFINE_GETTER_SETTER(GetLetterColor, SetLetterColor, _data.letter_color)
-		DEFINE_GETTER_SETTER(GetLineSize, SetLineSize, _data.line_size)
-		DEFINE_GETTER_SETTER(GetBoxColor, SetBoxColor, _data.box_color)
-		DEFINE_GETTER_SETTER(GetShadowLevel, SetShadowLevel, _data.shadow)
-		DEFINE_GETTER_SETTER(GetOutlineLevel, SetOutlineLevel, _data.outline)
-		DEFINE_GETTER_SETTER(GetBackgroundColor, SetBackgroundColor, _data.background_color)
-		DEFINE_GETTER_SETTER(GetFont, SetFont, _data.style)
-		DEFINE_GETTER_SETTER(IsSelectable, ToggleSelectable, _data.selectable)
-		DEFINE_GETTER_SETTER(GetPosition, SetPosition, _data.position)
-		DEFINE_GETTER_SETTER(GetPreviewModelID, SetPreviewModelID, _data.modelid)
-		DEFINE_GETTER_SETTER(GetPreviewModelRotation, SetPreviewModelRotation, _data.rotation)
-		DEFINE_GETTER_SETTER(GetPreviewModelZoom, SetPreviewModelZoom, _data.zoom)
-		DEFINE_GETTER_SETTER(GetPreviewModelColors, SetPreviewModelColors, _data.preview_colors)
+		DEFINE_GETTER_SETTER(UsingBox, ToggleBox, _data.box, box)
+		DEFINE_GETTER_SETTER(GetAlignment, SetAlignment, _data.alignment, alignment)
+		DEFINE_GETTER_SETTER(IsProportional, ToggleProportional, _data.proportional, proportional)
+		DEFINE_GETTER_SETTER(GetLetterSize, SetLetterSize, _data.letter_size, letter_size)
+		DEFINE_GETTER_SETTER(GetLetterColor, SetLetterColor, _data.letter_color, letter_color)
+		DEFINE_GETTER_SETTER(GetLineSize, SetLineSize, _data.line_size, line_size)
+		DEFINE_GETTER_SETTER(GetBoxColor, SetBoxColor, _data.box_color, box_color)
+		DEFINE_GETTER_SETTER(GetShadowLevel, SetShadowLevel, _data.shadow, shadow)
+		DEFINE_GETTER_SETTER(GetOutlineLevel, SetOutlineLevel, _data.outline, outline)
+		DEFINE_GETTER_SETTER(GetBackgroundColor, SetBackgroundColor, _data.background_color, background_color)
+		DEFINE_GETTER_SETTER(GetFont, SetFont, _data.style, font)
+		DEFINE_GETTER_SETTER(IsSelectable, ToggleSelectable, _data.selectable, selectable)
+		DEFINE_GETTER_SETTER(GetPosition, SetPosition, _data.position, position)
+		DEFINE_GETTER_SETTER(GetPreviewModelID, SetPreviewModelID, _data.modelid, preview_model)
+		DEFINE_GETTER_SETTER(GetPreviewModelRotation, SetPreviewModelRotation, _data.rotation, preview_rotation)
+		DEFINE_GETTER_SETTER(GetPreviewModelZoom, SetPreviewModelZoom, _data.zoom, preview_zoom)
+		DEFINE_GETTER_SETTER(GetPreviewModelColors, SetPreviewModelColors, _data.preview_colors, preview_colors)
 		inline auto GetText() const { return _data.text; }
-		// An implementation might choose to optimize this function to send a single TextDrawSetString RPC
-		virtual inline BaseTextDraw* SetText(std::string text) { _data.text = text; Update(); return this; }
+		virtual inline BaseTextDraw* SetText(std::string text) { if (_data.text != text) { _data.text = std::move(text); MarkDirty(property::text); } return this; }
+
+		// Setters only record what changed, the textdraw is sent once at the end of the server tick: a single
+		// TextDrawSetString if only the text changed, a full show otherwise. Flush() sends it right away.
+		void Flush();
+		inline bool Dirty() const { return _dirty != 0u; }
+		static void FlushAll();
+		// Disabling it sends every change as soon as it's made, only meant for comparing both modes
+		inline static void ToggleCoalescing(bool coalesce) { _coalesce = coalesce; }
+
+		// Animated textdraws send every change as a full show, so any frame that gets through is a complete state.
+		// They get one of the animation IDs when they're shown, so set it before that and keep it while shown.
+		inline BaseTextDraw* ToggleAnimated(bool animated) { _animated = animated; return this; }
+		// While set, changes of an animated textdraw go out as frames that may be lost; clear it for the last frame.
+		inline BaseTextDraw* AsFrame(bool frame = true) { _frame = frame; return this; }
+
+		// Decides what gets hidden first when a player runs out of textdraw IDs
+		inline BaseTextDraw* SetPriority(textdraw_priority priority) { _priority = priority; return this; }
+		inline textdraw_priority GetPriority() const { return _priority; }
 
 		inline BaseTextDraw* SetCallback(const std::function<void(CPlayer*)>& callback) { _data.callback = callback; return this; }
 
-		inline void CopyData(const stTextDrawData& data) { _data = data; }
+		inline void CopyData(const stTextDrawData& data) { _data = data; _payload.clear(); }
 		inline stTextDrawData GetData() const { return _data; }
 	};
 
@@ -198,11 +312,18 @@ namespace server
 		friend cell server::DestroyPlayerTextDraws(std::uint16_t playerid, std::uint8_t reason);
 		std::bitset<MAX_PLAYERS> _shown_for;
 		std::stack<stTextDrawData> _states;
+		mutable std::array<std::uint16_t, MAX_PLAYERS> _ids;
+		robin_hood::unordered_map<std::uint16_t, std::string> _text_overrides; // Only players that see a different text
 
 		void Update() override;
 		void Update(CPlayer* player);
+		void UpdateText() override;
+		inline std::uint16_t& IdSlot(std::uint16_t playerid) const override { return _ids[playerid]; }
+		inline bool PerPlayer() const override { return false; }
+		inline void Evict(CPlayer* player) override { Hide(player); }
+		void SendText(CPlayer* player, const std::string& text);
 	public:
-		TextDraw() = default;
+		TextDraw() { _ids.fill(TextDrawIndexManager::INVALID_ID); }
 		~TextDraw() override;
 
 		void PushState();
@@ -215,14 +336,21 @@ namespace server
 		inline bool ShownFor(CPlayer* player) const;
 
 		TextDraw* SetText(std::string text) override;
+		// Text only this player sees, dropped when the textdraw is hidden for them
+		TextDraw* SetTextFor(CPlayer* player, std::string text);
+		TextDraw* ResetTextFor(CPlayer* player);
 	};
 
 	class PlayerTextDraw final : public BaseTextDraw
 	{
 		std::uint16_t _playerid;
-		std::uint16_t _id{ 0xFFFF };
+		mutable std::uint16_t _id{ 0xFFFF };
 
 		void Update() override;
+		void UpdateText() override;
+		inline std::uint16_t& IdSlot(std::uint16_t) const override { return _id; }
+		inline bool PerPlayer() const override { return true; }
+		inline void Evict(CPlayer*) override { Hide(); }
 	public:
 		explicit PlayerTextDraw(std::uint16_t player)
 			: _playerid(player)
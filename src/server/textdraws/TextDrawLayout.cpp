@@ -0,0 +1,342 @@
+#include "../../main.hpp"
+
+// Groups list their elements in show order, by name or by index range: "global:0-13", "player:2", "global:18-" (up to the last one)
+static std::vector<server::layout::group> ParseGroups(const toml::table& tbl, const std::vector<server::layout::entry>& entries)
+{
+	std::vector<server::layout::group> groups;
+
+	auto* group_array = tbl["groups"].as_array();
+	if (!group_array)
+		return groups;
+
+	std::uint16_t count[2] = { 0, 0 };
+	robin_hood::unordered_map<std::string, server::layout::element_ref> names;
+	for (auto&& entry : entries)
+	{
+		const auto index = count[entry.player]++;
+		if (!entry.name.empty())
+			names[entry.name] = { entry.player, index };
+	}
+
+	for (auto&& group_node : *group_array)
+	{
+		auto* group_table = group_node.as_table();
+		if (!group_table)
+			continue;
+
+		server::layout::group group;
+		group.name = (*group_table)["name"].value_or<std::string>("");
+		if (group.name.empty())
+			throw std::runtime_error{ "textdraw group without name" };
+
+		if (auto* elements = (*group_table)["elements"].as_array())
+		{
+			for (auto&& element_node : *elements)
+			{
+				auto element = element_node.value_or<std::string>("");
+				auto colon = element.find(':');
+				if (colon == std::string::npos)
+				{
+					if (!names.contains(element))
+						throw std::runtime_error{ "unknown textdraw in group " + group.name };
+
+					group.elements.push_back(names[element]);
+					continue;
+				}
+
+				const bool player = (element.compare(0, colon, "player") == 0);
+				if (!player && element.compare(0, colon, "global") != 0)
+					throw std::runtime_error{ "invalid textdraw kind in group " + group.name };
+
+				std::string_view range{ element };
+				range.remove_prefix(colon + 1);
+
+				const auto dash = range.find('-');
+				const auto first_text = range.substr(0, dash);
+				std::uint16_t first = 0, last = 0;
+				if (std::from_chars(first_text.data(), first_text.data() + first_text.size(), first).ec != std::errc{})
+					throw std::runtime_error{ "invalid textdraw range in group " + group.name };
+
+				if (dash == std::string_view::npos)
+					last = first;
+				else if (dash + 1 == range.size())
+					last = count[player] - 1;
+				else if (std::from_chars(range.data() + dash + 1, range.data() + range.size(), last).ec != std::errc{})
+					throw std::runtime_error{ "invalid textdraw range in group " + group.name };
+
+				if (first > last || last >= count[player])
+					throw std::runtime_error{ "textdraw range out of bounds in group " + group.name };
+
+				for (auto index = first; index <= last; ++index)
+					group.elements.push_back({ player, index });
+			}
+		}
+
+		groups.push_back(std::move(group));
+	}
+
+	return groups;
+}
+
+server::layout::document server::layout::ParseToml(const std::filesystem::path& path)
+{
+	toml::table tbl = toml::parse_file(path.string());
+
+	if (!tbl.contains("textdraws"))
+		throw std::runtime_error{ "invalid textdraw file" };
+
+	toml::array* tdarray = tbl["textdraws"].as_array();
+	if (!tdarray)
+		throw std::runtime_error{ "invalid textdraw file" };
+
+	std::vector<entry> entries;
+	entries.reserve(tdarray->size());
+
+	for (auto&& td_node : *tdarray)
+	{
+		auto* td_data_ptr = td_node.as_table();
+		if (!td_data_ptr)
+			continue;
+		
+		const auto& td = *td_data_ptr;
+
+		stTextDrawData td_data{};
+#define IF_EXISTS_INSERT(key, type, data) \
+		if(auto value = td[key].value<type>()) \
+			td_data.data = *value
+
+#define IF_EXISTS_INSERT_PAIR(key, type, data, default_val) \
+		if(auto* arr_ptr = td[key].as_array(); arr_ptr && arr_ptr->size() >= 2) \
+		{ \
+			auto& arr = *arr_ptr; \
+			td_data.data = { arr[0].value_or<type>(default_val), arr[1].value_or<type>(default_val) }; \
+		}
+
+#define IF_EXISTS_INSERT_VEC3D(key, type, data, default_val) \
+		if(auto* arr_ptr = td[key].as_array(); arr_ptr && arr_ptr->size() >= 3) \
+		{ \
+			auto& arr = *arr_ptr; \
+			td_data.data = glm::vec3{ arr[0].value_or<type>(default_val), arr[1].value_or<type>(default_val), arr[2].value_or<type>(default_val) }; \
+		}
+
+		IF_EXISTS_INSERT_PAIR("position", float, position, 0.F);
+		IF_EXISTS_INSERT("text", std::string, text);
+		IF_EXISTS_INSERT("style", unsigned char, style);
+		IF_EXISTS_INSERT_PAIR("letter_size", float, letter_size, 0.F);
+		IF_EXISTS_INSERT_PAIR("line_size", float, line_size, 0.F);
+		IF_EXISTS_INSERT("outline", unsigned char, outline);
+		IF_EXISTS_INSERT("shadow", unsigned char, shadow);
+		IF_EXISTS_INSERT("alignment", unsigned char, alignment);
+		IF_EXISTS_INSERT("letter_color", int32_t, letter_color);
+		IF_EXISTS_INSERT("bg_color", int32_t, background_color);
+		IF_EXISTS_INSERT("box_color", int32_t, box_color);
+		IF_EXISTS_INSERT("box", bool, box);
+		IF_EXISTS_INSERT("proportional", bool, proportional);
+		IF_EXISTS_INSERT("selectable", bool, selectable);
+		IF_EXISTS_INSERT("modelid", unsigned short, modelid);
+		IF_EXISTS_INSERT_VEC3D("rotation", float, rotation, 0.F);
+		IF_EXISTS_INSERT("zoom", float, zoom);
+		IF_EXISTS_INSERT_PAIR("model_colors", int16_t, preview_colors, -1);
+
+#undef IF_EXISTS_INSERT_PAIR
+#undef IF_EXISTS_INSERT
+#undef IF_EXISTS_INSERT_VEC3D
+
+		entries.push_back({ std::move(td_data), td["player"].value_or<bool>(false), td["name"].value_or<std::string>("") });
+	}
+
+	auto groups = ParseGroups(tbl, entries);
+	return { std::move(entries), std::move(groups) };
+}
+
+std::optional<server::layout::document> server::layout::LoadCompiled(const std::filesystem::path& path, std::uint32_t source_crc)
+{
+	std::error_code ec;
+	if (!std::filesystem::is_regular_file(path, ec))
+		return std::nullopt;
+
+	try
+	{
+		utils::mapped_file file{ path };
+		if (file.size() < sizeof(stLayoutHeader) || !file.data())
+			return std::nullopt;
+
+		const auto* header = reinterpret_cast<const stLayoutHeader*>(file.data());
+		if (header->magic != LAYOUT_MAGIC || header->version != LAYOUT_VERSION || header->source_crc != source_crc)
+			return std::nullopt;
+
+		const std::size_t expected_size = sizeof(stLayoutHeader)
+			+ static_cast<std::size_t>(header->record_count) * sizeof(stLayoutRecord)
+			+ static_cast<std::size_t>(header->group_count) * sizeof(stLayoutGroup)
+			+ static_cast<std::size_t>(header->ref_count) * sizeof(stLayoutElementRef)
+			+ header->strings_size;
+		if (file.size() != expected_size)
+			return std::nullopt;
+
+		const auto* records = reinterpret_cast<const stLayoutRecord*>(file.data() + sizeof(stLayoutHeader));
+		const auto* groups = reinterpret_cast<const stLayoutGroup*>(records + header->record_count);
+		const auto* refs = reinterpret_cast<const stLayoutElementRef*>(groups + header->group_count);
+		const auto* strings = reinterpret_cast<const char*>(refs + header->ref_count);
+
+		auto in_strings = [header](std::uint32_t offset, std::uint32_t length) {
+			return static_cast<std::size_t>(offset) + length <= header->strings_size;
+		};
+
+		document layout;
+		layout.entries.resize(header->record_count);
+		// Group elements index the global and the per-player textdraws separately
+		std::array<std::size_t, 2> count{};
+		for (std::uint32_t i = 0; i < header->record_count; ++i)
+		{
+			const auto& record = records[i];
+			if (!in_strings(record.text_offset, record.text_length) || !in_strings(record.name_offset, record.name_length))
+				return std::nullopt;
+
+			auto& data = layout.entries[i].data;
+			data.box = (record.flags & stLayoutRecord::box) != 0;
+			data.proportional = (record.flags & stLayoutRecord::proportional) != 0;
+			data.selectable = (record.flags & stLayoutRecord::selectable) != 0;
+			data.alignment = record.alignment;
+			data.shadow = record.shadow;
+			data.outline = record.outline;
+			data.style = record.style;
+			data.letter_size = { record.letter_size[0], record.letter_size[1] };
+			data.letter_color = record.letter_color;
+			data.line_size = { record.line_size[0], record.line_size[1] };
+			data.box_color = record.box_color;
+			data.background_color = record.background_color;
+			data.position = { record.position[0], record.position[1] };
+			data.modelid = record.modelid;
+			data.rotation = { record.rotation[0], record.rotation[1], record.rotation[2] };
+			data.zoom = record.zoom;
+			data.preview_colors = { record.preview_colors[0], record.preview_colors[1] };
+			data.text.assign(strings + record.text_offset, record.text_length);
+			layout.entries[i].player = (record.flags & stLayoutRecord::player) != 0;
+			layout.entries[i].name.assign(strings + record.name_offset, record.name_length);
+			++count[layout.entries[i].player];
+		}
+
+		layout.groups.resize(header->group_count);
+		for (std::uint32_t i = 0; i < header->group_count; ++i)
+		{
+			const auto& group = groups[i];
+			if (!in_strings(group.name_offset, group.name_length) || static_cast<std::size_t>(group.first_ref) + group.ref_count > header->ref_count)
+				return std::nullopt;
+
+			layout.groups[i].name.assign(strings + group.name_offset, group.name_length);
+			for (std::uint32_t ref = group.first_ref; ref < group.first_ref + group.ref_count; ++ref)
+			{
+				const bool player = (refs[ref].player != 0);
+				if (refs[ref].index >= count[player])
+					return std::nullopt;
+
+				layout.groups[i].elements.push_back({ player, refs[ref].index });
+			}
+		}
+
+		return layout;
+	}
+	catch (const std::exception& e)
+	{
+		return std::nullopt;
+	}
+}
+
+bool server::layout::WriteCompiled(const std::filesystem::path& path, std::uint32_t source_crc, const document& layout)
+{
+	std::vector<stLayoutRecord> records;
+	records.reserve(layout.entries.size());
+	std::vector<stLayoutGroup> groups;
+	groups.reserve(layout.groups.size());
+	std::vector<stLayoutElementRef> refs;
+	std::string strings;
+
+	auto add_string = [&strings](const std::string& string, std::uint32_t& offset, std::uint32_t& length) {
+		offset = static_cast<std::uint32_t>(strings.size());
+		length = static_cast<std::uint32_t>(string.size());
+		strings += string;
+	};
+
+	for (auto&& [data, player, name] : layout.entries)
+	{
+		stLayoutRecord record{};
+		record.flags = (data.box ? stLayoutRecord::box : 0) | (data.proportional ? stLayoutRecord::proportional : 0) | (data.selectable ? stLayoutRecord::selectable : 0) | (player ? stLayoutRecord::player : 0);
+		record.alignment = data.alignment;
+		record.shadow = data.shadow;
+		record.outline = data.outline;
+		record.style = data.style;
+		record.letter_size[0] = data.letter_size.first;
+		record.letter_size[1] = data.letter_size.second;
+		record.letter_color = data.letter_color;
+		record.line_size[0] = data.line_size.first;
+		record.line_size[1] = data.line_size.second;
+		record.box_color = data.box_color;
+		record.background_color = data.background_color;
+		record.position[0] = data.position.first;
+		record.position[1] = data.position.second;
+		record.modelid = data.modelid;
+		record.rotation[0] = data.rotation.x;
+		record.rotation[1] = data.rotation.y;
+		record.rotation[2] = data.rotation.z;
+		record.zoom = data.zoom;
+		record.preview_colors[0] = data.preview_colors.first;
+		record.preview_colors[1] = data.preview_colors.second;
+		add_string(data.text, record.text_offset, record.text_length);
+		add_string(name, record.name_offset, record.name_length);
+		records.push_back(record);
+	}
+
+	for (auto&& [name, elements] : layout.groups)
+	{
+		stLayoutGroup group{};
+		add_string(name, group.name_offset, group.name_length);
+		group.first_ref = static_cast<std::uint32_t>(refs.size());
+		group.ref_count = static_cast<std::uint32_t>(elements.size());
+		groups.push_back(group);
+
+		for (auto&& element : elements)
+			refs.push_back({ static_cast<std::uint8_t>(element.player), element.index });
+	}
+
+	stLayoutHeader header{};
+	header.source_crc = source_crc;
+	header.record_count = static_cast<std::uint32_t>(records.size());
+	header.group_count = static_cast<std::uint32_t>(groups.size());
+	header.ref_count = static_cast<std::uint32_t>(refs.size());
+	header.strings_size = static_cast<std::uint32_t>(strings.size());
+
+	std::error_code ec;
+	std::filesystem::create_directories(path.parent_path(), ec);
+
+	auto temp_path = path;
+	temp_path += ".tmp";
+
+	{
+		std::ofstream file{ temp_path, std::ios::binary | std::ios::trunc };
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(stLayoutRecord));
+		file.write(reinterpret_cast<const char*>(groups.data()), groups.size() * sizeof(stLayoutGroup));
+		file.write(reinterpret_cast<const char*>(refs.data()), refs.size() * sizeof(stLayoutElementRef));
+		file.write(strings.data(), strings.size());
+
+		if (!file)
+		{
+			sampgdk::logprintf("[TextDraw] Couldn't write compiled layout %s.", temp_path.string().c_str());
+			return false;
+		}
+	}
+
+	std::filesystem::rename(temp_path, path, ec);
+	if (ec)
+	{
+		sampgdk::logprintf("[TextDraw] Couldn't replace compiled layout %s: %s.", path.string().c_str(), ec.message().c_str());
+		return false;
+	}
+
+	return true;
+}
+
+std::filesystem::path server::layout::CompiledPath(const std::filesystem::path& source)
+{
+	return source.parent_path() / "compiled" / source.filename().replace_extension(".tdl");
+}
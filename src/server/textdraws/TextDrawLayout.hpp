@@ -0,0 +1,91 @@
+#pragma once
+
+namespace server::layout
+{
+	constexpr std::uint32_t LAYOUT_MAGIC = 'THTL';
+	constexpr std::uint16_t LAYOUT_VERSION = 2;
+
+#pragma pack(push, 1)
+	// The header is followed by `record_count` records, `group_count` groups, the `ref_count` element references
+	// of all groups and by `strings_size` bytes of text they point into.
+	struct stLayoutHeader
+	{
+		std::uint32_t magic{ LAYOUT_MAGIC };
+		std::uint16_t version{ LAYOUT_VERSION };
+		std::uint16_t reserved{ 0 };
+		std::uint32_t source_crc{ 0 }; // CRC32 of the TOML file this was compiled from
+		std::uint32_t record_count{ 0 };
+		std::uint32_t group_count{ 0 };
+		std::uint32_t ref_count{ 0 };
+		std::uint32_t strings_size{ 0 };
+	};
+
+	struct stLayoutRecord
+	{
+		enum flag : std::uint8_t
+		{
+			box = 1 << 0,
+			proportional = 1 << 1,
+			selectable = 1 << 2,
+			player = 1 << 3
+		};
+
+		std::uint8_t flags;
+		std::uint8_t alignment;
+		std::uint8_t shadow;
+		std::uint8_t outline;
+		std::uint8_t style;
+		float letter_size[2];
+		std::uint32_t letter_color;
+		float line_size[2];
+		std::uint32_t box_color;
+		std::uint32_t background_color;
+		float position[2];
+		std::uint16_t modelid;
+		float rotation[3];
+		float zoom;
+		std::uint16_t preview_colors[2];
+		std::uint32_t text_offset;
+		std::uint32_t text_length;
+		std::uint32_t name_offset;
+		std::uint32_t name_length;
+	};
+
+	struct stLayoutGroup
+	{
+		std::uint32_t name_offset;
+		std::uint32_t name_length;
+		std::uint32_t first_ref;
+		std::uint32_t ref_count;
+	};
+
+	struct stLayoutElementRef
+	{
+		std::uint8_t player;
+		std::uint16_t index;
+	};
+#pragma pack(pop)
+
+	struct entry
+	{
+		stTextDrawData data;
+		bool player{ false };
+		std::string name;
+	};
+
+	struct document
+	{
+		std::vector<entry> entries;
+		std::vector<group> groups;
+	};
+
+	// Authoring format, throws toml::parse_error or std::runtime_error
+	document ParseToml(const std::filesystem::path& path);
+
+	// Returns nothing when the file is missing, damaged or was compiled from a different source
+	std::optional<document> LoadCompiled(const std::filesystem::path& path, std::uint32_t source_crc);
+	bool WriteCompiled(const std::filesystem::path& path, std::uint32_t source_crc, const document& layout);
+
+	// Where the compiled version of a layout file is cached
+	std::filesystem::path CompiledPath(const std::filesystem::path& source);
+}
@@ -2,79 +2,381 @@
 
 server::TextDrawManager textdraw_manager{};
 
-server::TextDrawList::TextDrawList(const std::string_view file)
+server::TextDrawIndexManager::TextDrawIndexManager(std::uint16_t playerid)
+	: _playerid(playerid)
 {
-	toml::table tbl = toml::parse_file(file);
+	_free.fill(~0ull);
+	for (auto id = FIRST_ANIMATION_ID; id < MAX_IDS; ++id)
+		_free[id / 64] &= ~(1ull << (id % 64));
+
+	for (auto&& lists : _lru_head)
+		lists.fill(INVALID_ID);
+	for (auto&& lists : _lru_tail)
+		lists.fill(INVALID_ID);
+}
 
-	if (!tbl.contains("textdraws"))
-		throw std::runtime_error{ "invalid textdraw file" };
+server::TextDrawIndexManager::~TextDrawIndexManager()
+{
+	// Global textdraws outlive the player, their slot must be free for whoever gets this player ID next
+	for (auto* td : _owners)
+	{
+		if (td)
+			td->IdSlot(_playerid) = INVALID_ID;
+	}
+}
 
-	toml::array* tdarray = tbl["textdraws"].as_array();
-	if (!tdarray)
-		throw std::runtime_error{ "invalid textdraw file" };
+std::optional<server::textdraw_priority> server::ParsePriority(std::string_view name)
+{
+	if (name == "hud")
+		return textdraw_priority::hud;
+	if (name == "notification")
+		return textdraw_priority::notification;
+	if (name == "decorative")
+		return textdraw_priority::decorative;
+
+	return std::nullopt;
+}
 
-	for (auto&& td_node : *tdarray)
+std::string_view server::PriorityName(textdraw_priority priority)
+{
+	switch (priority)
 	{
-		auto* td_data_ptr = td_node.as_table();
-		if (!td_data_ptr)
-			continue;
-		
-		const auto& td = *td_data_ptr;
-
-		stTextDrawData td_data{};
-#define IF_EXISTS_INSERT(key, type, data) \
-		if(auto value = td[key].value<type>()) \
-			td_data.data = *value
-
-#define IF_EXISTS_INSERT_PAIR(key, type, data, default_val) \
-		if(auto* arr_ptr = td[key].as_array(); arr_ptr && arr_ptr->size() >= 2) \
-		{ \
-			auto& arr = *arr_ptr; \
-			td_data.data = { arr[0].value_or<type>(default_val), arr[1].value_or<type>(default_val) }; \
-		}
-
-#define IF_EXISTS_INSERT_VEC3D(key, type, data, default_val) \
-		if(auto* arr_ptr = td[key].as_array(); arr_ptr && arr_ptr->size() >= 3) \
-		{ \
-			auto& arr = *arr_ptr; \
-			td_data.data = glm::vec3{ arr[0].value_or<type>(default_val), arr[1].value_or<type>(default_val), arr[2].value_or<type>(default_val) }; \
-		}
-
-		IF_EXISTS_INSERT_PAIR("position", float, position, 0.F);
-		IF_EXISTS_INSERT("text", std::string, text);
-		IF_EXISTS_INSERT("style", unsigned char, style);
-		IF_EXISTS_INSERT_PAIR("letter_size", float, letter_size, 0.F);
-		IF_EXISTS_INSERT_PAIR("line_size", float, line_size, 0.F);
-		IF_EXISTS_INSERT("outline", unsigned char, outline);
-		IF_EXISTS_INSERT("shadow", unsigned char, shadow);
-		IF_EXISTS_INSERT("alignment", unsigned char, alignment);
-		IF_EXISTS_INSERT("letter_color", int32_t, letter_color);
-		IF_EXISTS_INSERT("bg_color", int32_t, background_color);
-		IF_EXISTS_INSERT("box_color", int32_t, box_color);
-		IF_EXISTS_INSERT("box", bool, box);
-		IF_EXISTS_INSERT("proportional", bool, proportional);
-		IF_EXISTS_INSERT("selectable", bool, selectable);
-		IF_EXISTS_INSERT("modelid", unsigned short, modelid);
-		IF_EXISTS_INSERT_VEC3D("rotation", float, rotation, 0.F);
-		IF_EXISTS_INSERT("zoom", float, zoom);
-		IF_EXISTS_INSERT_PAIR("model_colors", int16_t, preview_colors, -1);
-
-#undef IF_EXISTS_INSERT_PAIR
-#undef IF_EXISTS_INSERT
-#undef IF_EXISTS_INSERT_VEC3D
-
-		const bool player = td["player"].value_or<bool>(false);
-		if (player)
-		{
-			_ptd_data.push_back(std::move(td_data));
+	case textdraw_priority::hud: return "hud";
+	case textdraw_priority::notification: return "notification";
+	case textdraw_priority::decorative: return "decorative";
+	default: return "unknown";
+	}
+}
+
+std::uint16_t server::TextDrawIndexManager::TakeFreeId(bool animated)
+{
+	if (animated && _free_animation)
+	{
+		const auto id = static_cast<std::uint16_t>(FIRST_ANIMATION_ID + std::countr_zero(_free_animation));
+		_free_animation &= _free_animation - 1;
+		return id;
+	}
+
+	for (; _first_free_word < WORDS; ++_first_free_word)
+	{
+		auto& word = _free[_first_free_word];
+		if (word)
+		{
+			const auto id = static_cast<std::uint16_t>(_first_free_word * 64 + std::countr_zero(word));
+			word &= word - 1;
+			return id;
+		}
+	}
+
+	return INVALID_ID;
+}
+
+void server::TextDrawIndexManager::LinkLru(std::uint16_t id)
+{
+	auto& link = _lru[id];
+	link.of_kind = (_owners[id]->PerPlayer() ? player : global);
+	link.priority = _owners[id]->GetPriority();
+
+	const auto priority = static_cast<std::size_t>(link.priority);
+	auto& tail = _lru_tail[link.of_kind][priority];
+	link.prev = tail;
+	link.next = INVALID_ID;
+	if (tail != INVALID_ID)
+		_lru[tail].next = id;
+	else
+		_lru_head[link.of_kind][priority] = id;
+	tail = id;
+}
+
+void server::TextDrawIndexManager::UnlinkLru(std::uint16_t id)
+{
+	auto& link = _lru[id];
+	const auto priority = static_cast<std::size_t>(link.priority);
+
+	if (link.prev != INVALID_ID)
+		_lru[link.prev].next = link.next;
+	else
+		_lru_head[link.of_kind][priority] = link.next;
+
+	if (link.next != INVALID_ID)
+		_lru[link.next].prev = link.prev;
+	else
+		_lru_tail[link.of_kind][priority] = link.prev;
+
+	link.prev = link.next = INVALID_ID;
+}
+
+void server::TextDrawIndexManager::Touch(std::uint16_t id)
+{
+	_last_use[id] = ++_clock;
+	if (_lru_tail[_lru[id].of_kind][static_cast<std::size_t>(_lru[id].priority)] == id && _lru[id].priority == _owners[id]->GetPriority())
+		return;
+
+	UnlinkLru(id);
+	LinkLru(id);
+}
+
+bool server::TextDrawIndexManager::Evict(std::optional<kind> of_kind, textdraw_priority priority)
+{
+	// Lowest priority first, least recently used among those: the head of the lists
+	std::uint16_t victim = INVALID_ID;
+	for (std::size_t level = 0; level < static_cast<std::size_t>(priority) && victim == INVALID_ID; ++level)
+	{
+		for (std::uint8_t candidate_kind = 0; candidate_kind < max_kinds; ++candidate_kind)
+		{
+			if (of_kind && *of_kind != candidate_kind)
+				continue;
+
+			const auto head = _lru_head[candidate_kind][level];
+			if (head != INVALID_ID && (victim == INVALID_ID || _last_use[head] < _last_use[victim]))
+				victim = head;
+		}
+	}
+
+	if (victim == INVALID_ID)
+		return false;
+
+	_owners[victim]->Evict(server::player_pool[_playerid]);
+	// An ID can be claimed without the textdraw being shown yet, hiding it doesn't release it then
+	FreeId(victim);
+	++_evictions;
+	return true;
+}
+
+std::uint16_t server::TextDrawIndexManager::ClaimFreeId(BaseTextDraw* td)
+{
+	const kind of_kind = (td->PerPlayer() ? player : global);
+	if (_used[of_kind] >= _budget[of_kind] && !Evict(of_kind, td->GetPriority()))
+	{
+		++_failures;
+		sampgdk::logprintf("[TextDraws] Player %u ran out of %s textdraw IDs (%u in use).", _playerid, (of_kind == player ? "per-player" : "global"), _used[of_kind]);
+		return INVALID_ID;
+	}
+
+	// Both kinds share the ID space, so it can run out before either budget does if they're raised
+	auto id = TakeFreeId(td->_animated);
+	if (id == INVALID_ID && Evict(std::nullopt, td->GetPriority()))
+		id = TakeFreeId(td->_animated);
+
+	if (id == INVALID_ID)
+	{
+		++_failures;
+		sampgdk::logprintf("[TextDraws] Player %u ran out of textdraw IDs.", _playerid);
+		return INVALID_ID;
+	}
+
+	_owners[id] = td;
+	_last_use[id] = ++_clock;
+	LinkLru(id);
+	++_used[of_kind];
+	td->IdSlot(_playerid) = id;
+	return id;
+}
+
+void server::TextDrawIndexManager::FreeId(std::uint16_t id)
+{
+	if (id >= MAX_IDS || !_owners[id])
+		return;
+
+	--_used[_owners[id]->PerPlayer() ? player : global];
+	UnlinkLru(id);
+	_owners[id]->IdSlot(_playerid) = INVALID_ID;
+	_owners[id] = nullptr;
+	if (id >= FIRST_ANIMATION_ID)
+	{
+		_free_animation |= (1u << (id - FIRST_ANIMATION_ID));
+		return;
+	}
+
+	_free[id / 64] |= (1ull << (id % 64));
+	_first_free_word = std::min<std::size_t>(_first_free_word, id / 64);
+}
+
+void server::TextDrawIndexManager::FreeId(const BaseTextDraw* td)
+{
+	FreeId(td->IdSlot(_playerid));
+}
+
+std::uint16_t server::TextDrawIndexManager::operator[](BaseTextDraw* td)
+{
+	const auto id = td->IdSlot(_playerid);
+	if (id == INVALID_ID)
+		return ClaimFreeId(td);
+
+	Touch(id);
+	return id;
+}
+
+std::uint16_t server::TextDrawIndexManager::Lookup(BaseTextDraw* td)
+{
+	const auto id = td->IdSlot(_playerid);
+	if (id != INVALID_ID)
+		Touch(id);
+
+	return id;
+}
+
+bool server::TextDrawIndexManager::Shown(const BaseTextDraw* td) const
+{
+	return td->IdSlot(_playerid) != INVALID_ID;
+}
+
+auto server::TextDrawIndexManager::Usage() const -> std::array<std::array<std::uint16_t, static_cast<std::size_t>(textdraw_priority::max_priorities)>, max_kinds>
+{
+	std::array<std::array<std::uint16_t, static_cast<std::size_t>(textdraw_priority::max_priorities)>, max_kinds> usage{};
+	for (auto* owner : _owners)
+	{
+		if (owner)
+			++usage[owner->PerPlayer() ? player : global][static_cast<std::size_t>(owner->GetPriority())];
+	}
+
+	return usage;
+}
+
+server::TextDrawList::TextDrawList(layout::document&& layout, textdraw_priority priority)
+	: _groups(std::move(layout.groups)),
+	_priority(priority)
+{
+	for (auto&& entry : layout.entries)
+	{
+		if (entry.player)
+		{
+			_ptd_data.push_back(std::move(entry.data));
+		}
+		else
+		{
+			auto td_ptr = std::make_unique<TextDraw>();
+			td_ptr->CopyData(entry.data);
+			td_ptr->SetPriority(_priority);
+			_textdraws.push_back(std::move(td_ptr));
+			_td_data.push_back(std::move(entry.data));
+		}
+	}
+}
+
+static void ApplyLayoutChanges(server::BaseTextDraw* td, const server::stTextDrawData& from, const server::stTextDrawData& to)
+{
+#define APPLY_IF_CHANGED(field, setter) \
+	if (from.field != to.field) \
+		td->setter(to.field)
+
+	APPLY_IF_CHANGED(box, ToggleBox);
+	APPLY_IF_CHANGED(alignment, SetAlignment);
+	APPLY_IF_CHANGED(proportional, ToggleProportional);
+	APPLY_IF_CHANGED(letter_size, SetLetterSize);
+	APPLY_IF_CHANGED(letter_color, SetLetterColor);
+	APPLY_IF_CHANGED(line_size, SetLineSize);
+	APPLY_IF_CHANGED(box_color, SetBoxColor);
+	APPLY_IF_CHANGED(shadow, SetShadowLevel);
+	APPLY_IF_CHANGED(outline, SetOutlineLevel);
+	APPLY_IF_CHANGED(background_color, SetBackgroundColor);
+	APPLY_IF_CHANGED(style, SetFont);
+	APPLY_IF_CHANGED(selectable, ToggleSelectable);
+	APPLY_IF_CHANGED(position, SetPosition);
+	APPLY_IF_CHANGED(modelid, SetPreviewModelID);
+	APPLY_IF_CHANGED(rotation, SetPreviewModelRotation);
+	APPLY_IF_CHANGED(zoom, SetPreviewModelZoom);
+	APPLY_IF_CHANGED(preview_colors, SetPreviewModelColors);
+	APPLY_IF_CHANGED(text, SetText);
+
+#undef APPLY_IF_CHANGED
+}
+
+void server::TextDrawList::Apply(layout::document&& layout)
+{
+	std::vector<stTextDrawData> td_data, ptd_data;
+	for (auto&& entry : layout.entries)
+	{
+		(entry.player ? ptd_data : td_data).push_back(std::move(entry.data));
+	}
+
+	// Click handlers are installed by the gamemode, the layout file never has them. The templates are used for
+	// players that join after the reload, so they need to keep them
+	for (std::size_t i = 0; i < std::min(td_data.size(), _td_data.size()); ++i)
+		td_data[i].callback = std::move(_td_data[i].callback);
+
+	for (std::size_t i = 0; i < std::min(ptd_data.size(), _ptd_data.size()); ++i)
+		ptd_data[i].callback = std::move(_ptd_data[i].callback);
+
+	// Changes go through the setters, so they're coalesced and re-sent with the IDs players already have
+	const auto global_count = _textdraws.size();
+	for (std::size_t i = 0; i < td_data.size(); ++i)
+	{
+		if (i < _textdraws.size())
+		{
+			ApplyLayoutChanges(_textdraws[i].get(), _td_data[i], td_data[i]);
 		}
 		else
 		{
 			auto td_ptr = std::make_unique<TextDraw>();
-			td_ptr->CopyData(td_data);
+			td_ptr->CopyData(td_data[i]);
+			td_ptr->SetPriority(_priority);
 			_textdraws.push_back(std::move(td_ptr));
 		}
 	}
+
+	// Destroying a textdraw hides it for everyone
+	if (_textdraws.size() > td_data.size())
+		_textdraws.erase(_textdraws.begin() + td_data.size(), _textdraws.end());
+
+	for (std::uint16_t playerid = 0; playerid < MAX_PLAYERS; ++playerid)
+	{
+		if (!_shown_for.test(playerid))
+			continue;
+
+		for (std::size_t i = global_count; i < _textdraws.size(); ++i)
+			_textdraws[i]->Show(server::player_pool[playerid]);
+	}
+
+	for (std::uint16_t playerid = 0; playerid < MAX_PLAYERS; ++playerid)
+	{
+		auto& textdraws = _player_textdraws[playerid];
+		if (textdraws.empty())
+			continue;
+
+		const auto player_count = textdraws.size();
+		for (std::size_t i = 0; i < ptd_data.size(); ++i)
+		{
+			if (i < textdraws.size())
+			{
+				ApplyLayoutChanges(textdraws[i].get(), _ptd_data[i], ptd_data[i]);
+			}
+			else
+			{
+				auto td = std::make_unique<PlayerTextDraw>(playerid);
+				td->CopyData(ptd_data[i]);
+				td->SetPriority(_priority);
+				textdraws.push_back(std::move(td));
+			}
+		}
+
+		if (textdraws.size() > ptd_data.size())
+			textdraws.erase(textdraws.begin() + ptd_data.size(), textdraws.end());
+
+		if (_shown_for.test(playerid))
+		{
+			for (std::size_t i = player_count; i < textdraws.size(); ++i)
+				textdraws[i]->Show();
+		}
+	}
+
+	_td_data = std::move(td_data);
+	_ptd_data = std::move(ptd_data);
+	_groups = std::move(layout.groups);
+}
+
+void server::TextDrawList::SetPriority(textdraw_priority priority)
+{
+	_priority = priority;
+
+	for (auto&& td : _textdraws)
+		td->SetPriority(priority);
+
+	for (auto&& textdraws : _player_textdraws)
+	{
+		for (auto&& td : textdraws)
+			td->SetPriority(priority);
+	}
 }
 
 void server::TextDrawList::CreateForPlayer(CPlayer* player)
@@ -86,6 +388,7 @@ void server::TextDrawList::CreateForPlayer(CPlayer* player)
 	{
 		auto td = std::make_unique<PlayerTextDraw>(playerid);
 		td->CopyData(data);
+		td->SetPriority(_priority);
 		_player_textdraws[playerid].push_back(std::move(td));
 	}
 }
@@ -111,6 +414,8 @@ void server::TextDrawList::Show(CPlayer* player)
 	{
 		td->Show();
 	}
+
+	_shown_for.set(player->PlayerId());
 }
 
 void server::TextDrawList::Show(CPlayer* player, unsigned short first, unsigned short last)
@@ -157,6 +462,60 @@ void server::TextDrawList::Show(CPlayer* player, unsigned short global_first, un
 
 }
 
+const server::layout::group* server::TextDrawList::Group(std::string_view name) const
+{
+	auto it = std::find_if(_groups.begin(), _groups.end(), [name](const layout::group& group) { return group.name == name; });
+	return (it != _groups.end() ? &*it : nullptr);
+}
+
+bool server::TextDrawList::Show(CPlayer* player, std::string_view name)
+{
+	auto* group = Group(name);
+	if (!group)
+		return false;
+
+	auto& player_textdraws = GetPlayerTextDraws(player);
+	for (auto&& [is_player, index] : group->elements)
+	{
+		if (is_player)
+		{
+			if (index < player_textdraws.size())
+				player_textdraws[index]->Show();
+		}
+		else if (index < _textdraws.size())
+		{
+			_textdraws[index]->Show(player);
+		}
+	}
+
+	return true;
+}
+
+bool server::TextDrawList::Hide(CPlayer* player, std::string_view name)
+{
+	auto* group = Group(name);
+	if (!group)
+		return false;
+
+	_shown_for.reset(player->PlayerId());
+
+	auto& player_textdraws = _player_textdraws[player->PlayerId()];
+	for (auto&& [is_player, index] : group->elements)
+	{
+		if (is_player)
+		{
+			if (index < player_textdraws.size())
+				player_textdraws[index]->Hide();
+		}
+		else if (index < _textdraws.size())
+		{
+			_textdraws[index]->Hide(player);
+		}
+	}
+
+	return true;
+}
+
 void server::TextDrawList::Hide(CPlayer* player)
 {
 	for (auto&& td : _textdraws)
@@ -164,42 +523,71 @@ void server::TextDrawList::Hide(CPlayer* player)
 		td->Hide(player);
 	}
 
+	_shown_for.reset(player->PlayerId());
 	DestroyForPlayer(player->PlayerId());
 }
 
-server::TextDrawList* server::TextDrawManager::LoadFile(const std::string_view file, const std::string& id)
+server::TextDrawList* server::TextDrawManager::LoadFile(const std::string_view file, const std::string& id, textdraw_priority priority)
 {
 	std::filesystem::path filepath{ std::filesystem::current_path() / "scriptfiles" / "textdraws" / file };
 	if (!filepath.has_extension())
 		filepath = filepath.replace_extension(".toml");
 
-	std::ifstream hfile{ filepath, std::ios::binary };
-	if (!hfile)
+	utils::mapped_file source;
+	try
+	{
+		source = utils::mapped_file{ filepath };
+	}
+	catch (const std::exception& e)
 	{
 		sampgdk::logprintf("[TextDraw] Failed to parse file %s: couldn't open file", file.data());
 		return nullptr;
 	}
 
 	auto hash_function = Botan::HashFunction::create("CRC32");
-	std::stringstream file_content;
-	file_content << hfile.rdbuf();
-	std::string file_content_s = file_content.str();
-	auto csum_bytes = hash_function->process(file_content_s);
+	auto csum_bytes = hash_function->process(source.data(), source.size());
 	
-	if (_td_lists.contains(id))
+	if (_td_lists.contains(id) && _td_lists[id].file_csum == csum_bytes)
 	{
-		if (_td_lists[id].file_csum == csum_bytes)
-			return _td_lists[id].list.get();
+		if (_td_lists[id].priority != priority)
+		{
+			_td_lists[id].list->SetPriority(priority);
+			_td_lists[id].priority = priority;
+		}
 
-		_td_lists.erase(id);
+		return _td_lists[id].list.get();
 	}
 
+	const std::uint32_t source_crc = (csum_bytes[0] << 24) | (csum_bytes[1] << 16) | (csum_bytes[2] << 8) | csum_bytes[3];
+	const auto compiled_path = layout::CompiledPath(filepath);
+
 	try
 	{
-		_td_lists[id].list = std::make_unique<TextDrawList>(filepath.string());
+		// The compiled layout is only trusted when it was built from this exact TOML, otherwise it's rebuilt
+		auto document = layout::LoadCompiled(compiled_path, source_crc);
+		const bool compiled = document.has_value();
+		if (!compiled)
+		{
+			document = layout::ParseToml(filepath);
+			layout::WriteCompiled(compiled_path, source_crc, *document);
+		}
+
+		// A list that's already loaded may be shown to players right now, it's updated in place
+		if (_td_lists[id].list)
+		{
+			_td_lists[id].list->SetPriority(priority);
+			_td_lists[id].list->Apply(std::move(*document));
+		}
+		else
+		{
+			_td_lists[id].list = std::make_unique<TextDrawList>(std::move(*document), priority);
+		}
+
 		_td_lists[id].file_csum = std::move(csum_bytes);
+		_td_lists[id].file = file;
+		_td_lists[id].priority = priority;
 
-		sampgdk::logprintf("[TextDraws] Loaded %i textdraws (%i public, %i per-player) from file %s (CRC32: %s).", _td_lists[id].list->_textdraws.size() + _td_lists[id].list->_ptd_data.size(), _td_lists[id].list->_textdraws.size(), _td_lists[id].list->_ptd_data.size(), file.data(), Botan::hex_encode(_td_lists[id].file_csum).c_str());
+		sampgdk::logprintf("[TextDraws] Loaded %i textdraws (%i public, %i per-player) from %s file %s (CRC32: %s).", _td_lists[id].list->_textdraws.size() + _td_lists[id].list->_ptd_data.size(), _td_lists[id].list->_textdraws.size(), _td_lists[id].list->_ptd_data.size(), (compiled ? "compiled" : "source"), file.data(), Botan::hex_encode(_td_lists[id].file_csum).c_str());
 
 		return _td_lists[id].list.get();
 	}
@@ -209,12 +597,166 @@ server::TextDrawList* server::TextDrawManager::LoadFile(const std::string_view f
 	}
 	catch (const std::runtime_error& e)
 	{
-
+		sampgdk::logprintf("[TextDraw] Failed to load file %s: %s", file.data(), e.what());
 	}
 
 	return nullptr;
 }
 
+std::size_t server::TextDrawManager::LoadManifest(const std::filesystem::path& path)
+{
+	toml::table tbl;
+	try
+	{
+		tbl = toml::parse_file(path.string());
+	}
+	catch (const toml::parse_error& e)
+	{
+		sampgdk::logprintf("[TextDraw] Failed to parse manifest %s: %s", path.string().c_str(), e.what());
+		return 0u;
+	}
+
+	auto* layouts = tbl["layouts"].as_array();
+	if (!layouts)
+	{
+		sampgdk::logprintf("[TextDraw] Manifest %s has no layouts.", path.string().c_str());
+		return 0u;
+	}
+
+	std::size_t count = 0u;
+	for (auto&& node : *layouts)
+	{
+		auto* layout = node.as_table();
+		if (!layout)
+			continue;
+
+		auto id = (*layout)["id"].value<std::string>();
+		auto file = (*layout)["file"].value<std::string>();
+		if (!id || !file)
+		{
+			sampgdk::logprintf("[TextDraw] Skipping manifest entry without id or file.");
+			continue;
+		}
+
+		auto priority = textdraw_priority::hud;
+		if (auto name = (*layout)["priority"].value<std::string>())
+		{
+			if (auto parsed = ParsePriority(*name))
+				priority = *parsed;
+			else
+				sampgdk::logprintf("[TextDraw] Unknown priority \"%s\" for layout %s, using hud.", name->c_str(), id->c_str());
+		}
+
+		if (auto instances = (*layout)["instances"].value<std::int64_t>())
+		{
+			for (std::int64_t i = 0; i < *instances; ++i)
+			{
+				if (LoadFile(*file, fmt::format("{}_{}", *id, i), priority))
+					++count;
+			}
+		}
+		else if (LoadFile(*file, *id, priority))
+		{
+			++count;
+		}
+	}
+
+	return count;
+}
+
+server::TextDrawList* server::TextDrawManager::Reload(const std::string& id)
+{
+	if (!_td_lists.contains(id))
+		return nullptr;
+
+	// LoadFile overwrites the stored file name
+	const std::string file = _td_lists[id].file;
+	return LoadFile(file, id, _td_lists[id].priority);
+}
+
+bool server::TextDrawManager::Watch(const std::filesystem::path& directory)
+{
+	StopWatching();
+
+	_watcher = new uv_fs_event_t;
+	uv_fs_event_init(uv_default_loop(), _watcher);
+	_watcher->data = this;
+
+	if (int err = uv_fs_event_start(_watcher, OnDirectoryChanged, directory.string().c_str(), 0); err < 0)
+	{
+		sampgdk::logprintf("[TextDraws] Couldn't watch %s: %s", directory.string().c_str(), uv_strerror(err));
+		StopWatching();
+		return false;
+	}
+
+	_directory = directory;
+	return true;
+}
+
+void server::TextDrawManager::StopWatching()
+{
+	if (!_watcher)
+		return;
+
+	uv_fs_event_stop(_watcher);
+	uv_close(reinterpret_cast<uv_handle_t*>(_watcher), [](uv_handle_t* handle) {
+		delete reinterpret_cast<uv_fs_event_t*>(handle);
+	});
+	_watcher = nullptr;
+}
+
+void server::TextDrawManager::OnDirectoryChanged(uv_fs_event_t* handle, const char* filename, int events, int status)
+{
+	if (status < 0 || !filename)
+		return;
+
+	std::filesystem::path changed{ filename };
+	if (changed.extension() != ".toml")
+		return;
+
+	auto* manager = static_cast<TextDrawManager*>(handle->data);
+	manager->_changed_files.insert(changed.filename().string());
+
+	if (!manager->_reload_scheduled)
+	{
+		manager->_reload_scheduled = true;
+		timers::timer_manager->Once(RELOAD_DELAY, [manager](timers::CTimer*) {
+			manager->ReloadChanged();
+		});
+	}
+}
+
+void server::TextDrawManager::ReloadChanged()
+{
+	_reload_scheduled = false;
+	auto changed = std::move(_changed_files);
+	_changed_files.clear();
+
+	// The manifest reloads everything it lists, unchanged files are skipped by their checksum
+	if (changed.contains("manifest.toml"))
+	{
+		LoadManifest(_directory / "manifest.toml");
+		return;
+	}
+
+	std::vector<std::string> ids;
+	for (auto&& [id, list] : _td_lists)
+	{
+		std::filesystem::path file{ list.file };
+		if (!file.has_extension())
+			file.replace_extension(".toml");
+
+		if (changed.contains(file.filename().string()))
+			ids.push_back(id);
+	}
+
+	for (auto&& id : ids)
+	{
+		if (Reload(id))
+			sampgdk::logprintf("[TextDraws] Reloaded %s after it changed on disk.", id.c_str());
+	}
+}
+
 std::vector<std::unique_ptr<server::PlayerTextDraw>>& server::TextDrawList::GetPlayerTextDraws(CPlayer* player)
 {
 	if (_player_textdraws[player->PlayerId()].empty())
@@ -228,9 +770,74 @@ cell server::DestroyPlayerTextDraws(std::uint16_t playerid, std::uint8_t reason)
 	for (auto&& [id, listfile] : textdraw_manager._td_lists)
 	{
 		listfile.list->_player_textdraws[playerid].clear();
+		listfile.list->_shown_for.reset(playerid);
+
+		for (auto&& td : listfile.list->_textdraws)
+		{
+			td->_shown_for.reset(playerid);
+			td->_text_overrides.erase(playerid);
+		}
 	}
 
 	return 1;
 }
 
 static CPublicHook<server::DestroyPlayerTextDraws> _tdm_opd("OnPlayerDisconnect");
+
+static public_prehook _tdm_ogmi("OnGameModeInit", [] {
+	const auto directory = std::filesystem::current_path() / "scriptfiles" / "textdraws";
+	auto count = textdraw_manager.LoadManifest(directory / "manifest.toml");
+	sampgdk::logprintf("[TextDraws] Loaded %u layouts from the manifest.", count);
+
+	textdraw_manager.Watch(directory);
+});
+
+static command tdreload_cmd("tdreload", command::make_flag<player::rank::admin>, [](CPlayer* player, cmd::argument_store args) {
+	if (args.empty())
+	{
+		auto count = textdraw_manager.LoadManifest(std::filesystem::current_path() / "scriptfiles" / "textdraws" / "manifest.toml");
+		player->Chat()->Send(0xDADADAFF, "Se han recargado {{ED2B2B}}{}{{DADADA}} diseos de textdraws.", count);
+		return;
+	}
+
+	std::string id;
+	args >> id;
+
+	if (!textdraw_manager.Reload(id))
+	{
+		player->Chat()->Send(0xED2B2BFF, "[ERROR] {DADADA}No existe ningn diseo de textdraws con ese nombre.");
+		return;
+	}
+
+	player->Chat()->Send(0xDADADAFF, "Diseo {{ED2B2B}}{}{{DADADA}} recargado.", id);
+});
+
+static command tdslots_cmd("tdslots", command::make_flag<player::rank::admin>, [](CPlayer* player, cmd::argument_store args) {
+	CPlayer* target = player;
+	if (!args.empty())
+	{
+		args >> target;
+		if (!target)
+		{
+			player->Chat()->Send(0xED2B2BFF, "[ERROR] {DADADA}Ese jugador no est conectado.");
+			return;
+		}
+	}
+
+	using index_manager = server::TextDrawIndexManager;
+	const auto& indexer = target->TextDraws();
+	const auto usage = indexer.Usage();
+
+	player->Chat()->Send(0xDADADAFF, "Textdraws de {{ED2B2B}}{}{{DADADA}} ({}):", target->Name(), target->PlayerId());
+	for (auto of_kind : { index_manager::global, index_manager::player })
+	{
+		const auto& by_priority = usage[of_kind];
+		player->Chat()->Send(0xDADADAFF, "{}: {{ED2B2B}}{}/{}{{DADADA}} (HUD {}, notificaciones {}, decorativos {})",
+			(of_kind == index_manager::global ? "Globales" : "Por jugador"), indexer.Used(of_kind), indexer.Budget(of_kind),
+			by_priority[static_cast<std::size_t>(server::textdraw_priority::hud)],
+			by_priority[static_cast<std::size_t>(server::textdraw_priority::notification)],
+			by_priority[static_cast<std::size_t>(server::textdraw_priority::decorative)]);
+	}
+
+	player->Chat()->Send(0xDADADAFF, "Expulsados: {{ED2B2B}}{}{{DADADA}}, sin hueco: {{ED2B2B}}{}{{DADADA}}.", indexer.Evictions(), indexer.Failures());
+});
@@ -10,6 +10,37 @@ namespace server
     class BaseTextDraw;
     struct stTextDrawData;
 
+    namespace layout
+    {
+        struct document;
+
+        struct element_ref
+        {
+            bool player;
+            std::uint16_t index;
+        };
+
+        // A named, ordered set of elements that are shown and hidden together
+        struct group
+        {
+            std::string name;
+            std::vector<element_ref> elements;
+        };
+    }
+
+    // Which textdraws give way when a player runs out of IDs, from least to most important
+    enum class textdraw_priority : std::uint8_t
+    {
+        decorative,
+        notification,
+        hud,
+
+        max_priorities
+    };
+
+    std::optional<textdraw_priority> ParsePriority(std::string_view name);
+    std::string_view PriorityName(textdraw_priority priority);
+
     cell DestroyPlayerTextDraws(std::uint16_t playerid, std::uint8_t reason);
 
     namespace textdraw 
@@ -17,51 +48,98 @@ namespace server
         cell OnPlayerClickTextDraw(std::uint16_t playerid, std::uint16_t clickedid);
     }
 
+    // Per-player textdraw IDs. The ID a textdraw got for a player is stored in the textdraw itself (see
+    // BaseTextDraw::IdSlot) and the owner of every ID is kept here, so both directions are a single index.
+    // Global and per-player textdraws have separate budgets; when one is spent, the least recently used
+    // textdraw of a lower priority is hidden to make room.
     class TextDrawIndexManager
     {
-        friend cell server::textdraw::OnPlayerClickTextDraw(std::uint16_t playerid, std::uint16_t clickedid);
+    public:
+        static constexpr std::uint16_t MAX_IDS = net::TEXTDRAW_IDS;
+        static constexpr std::uint16_t INVALID_ID = 0xFFFF;
+        // Only animated textdraws get these, each one has a delivery channel to itself, see GetTextDrawSendPolicy
+        static constexpr std::uint16_t FIRST_ANIMATION_ID = net::FIRST_ANIMATION_TEXTDRAW_ID;
+        static constexpr std::uint16_t ANIMATION_IDS = MAX_IDS - FIRST_ANIMATION_ID;
 
-        std::bitset<2304> _slots;
-        robin_hood::unordered_map<const BaseTextDraw*, std::uint16_t> _ids;
+        // What the client can hold of each kind
+        static constexpr std::uint16_t GLOBAL_BUDGET = 2048;
+        static constexpr std::uint16_t PLAYER_BUDGET = 256;
 
-    public:
-        inline std::uint16_t ClaimFreeId(const BaseTextDraw* td)
+        enum kind : std::uint8_t
         {
-            for (uint16_t bit = 0u; bit < _slots.size(); ++bit)
-            {
-                if (!_slots[bit])
-                {
-                    _slots.flip(bit);
-                    _ids[td] = bit;
-                    return bit;
-                }
-            }
-            return 0xFFFF;
-        }
+            global,
+            player,
 
-        inline void FreeId(std::uint16_t id)
-        {
-            _slots.set(id, false);
-        }
+            max_kinds
+        };
 
-        inline void FreeId(const BaseTextDraw* td)
-        {
-            if (Shown(td))
-            {
-                _slots.set(_ids[td], false);
-                _ids.erase(td);
-            }
-        }
+    private:
+        static constexpr std::size_t WORDS = MAX_IDS / 64;
 
-        std::uint16_t operator[](const BaseTextDraw* td)
-        {
-            return (!_ids.contains(td) ? (_ids[td] = ClaimFreeId(td)) : _ids[td]);
-        }
+        std::uint16_t _playerid;
+        std::array<std::uint64_t, WORDS> _free; // Set bits are free IDs, animation IDs are never set here
+        std::uint32_t _free_animation{ (1u << ANIMATION_IDS) - 1u };
+        static_assert(ANIMATION_IDS < 32);
+        std::array<BaseTextDraw*, MAX_IDS> _owners{};
+        std::size_t _first_free_word{ 0u }; // No free IDs below this word
+
+        static constexpr std::size_t PRIORITIES = static_cast<std::size_t>(textdraw_priority::max_priorities);
 
-        inline bool Shown(const BaseTextDraw* td) const
+        std::array<std::uint32_t, MAX_IDS> _last_use{}; // Value of _clock when the ID was last claimed or looked up
+        std::uint32_t _clock{ 0u };
+        // IDs in use, one list per kind and priority from least to most recently used, so eviction never walks the IDs
+        struct lru_link
         {
-            return _ids.contains(td);
-        }
+            std::uint16_t prev{ INVALID_ID };
+            std::uint16_t next{ INVALID_ID };
+            kind of_kind{ global };
+            textdraw_priority priority{ textdraw_priority::decorative };
+        };
+        std::array<lru_link, MAX_IDS> _lru{};
+        std::array<std::array<std::uint16_t, PRIORITIES>, max_kinds> _lru_head;
+        std::array<std::array<std::uint16_t, PRIORITIES>, max_kinds> _lru_tail;
+        std::array<std::uint16_t, max_kinds> _used{};
+        std::array<std::uint16_t, max_kinds> _budget{ GLOBAL_BUDGET, PLAYER_BUDGET };
+        std::uint32_t _evictions{ 0u };
+        std::uint32_t _failures{ 0u };
+
+        // Animated textdraws take an animation ID when there is one left
+        std::uint16_t TakeFreeId(bool animated);
+        void LinkLru(std::uint16_t id);
+        void UnlinkLru(std::uint16_t id);
+        // Moves the ID to the most recently used end of its list, which follows the owner if its priority changed
+        void Touch(std::uint16_t id);
+        // Hides the least recently used textdraw below `priority`, of the given kind or of any kind.
+        // Only ever reached from claims, never while a multicast is resolving IDs, see Lookup
+        bool Evict(std::optional<kind> of_kind, textdraw_priority priority);
+
+    public:
+        explicit TextDrawIndexManager(std::uint16_t playerid);
+        ~TextDrawIndexManager();
+
+        TextDrawIndexManager(const TextDrawIndexManager&) = delete;
+        TextDrawIndexManager& operator=(const TextDrawIndexManager&) = delete;
+
+        std::uint16_t ClaimFreeId(BaseTextDraw* td);
+        void FreeId(std::uint16_t id);
+        void FreeId(const BaseTextDraw* td);
+
+        // Claims an ID if the textdraw has none, which may evict another textdraw
+        std::uint16_t operator[](BaseTextDraw* td);
+        // Never claims, INVALID_ID if the textdraw has no ID. What multicast resolvers use, so sending a textdraw
+        // can't hide another one halfway through
+        std::uint16_t Lookup(BaseTextDraw* td);
+        bool Shown(const BaseTextDraw* td) const;
+
+        inline const BaseTextDraw* Owner(std::uint16_t id) const { return (id < MAX_IDS ? _owners[id] : nullptr); }
+
+        inline std::uint16_t Used(kind of_kind) const { return _used[of_kind]; }
+        inline std::uint16_t Budget(kind of_kind) const { return _budget[of_kind]; }
+        inline void SetBudget(kind of_kind, std::uint16_t budget) { _budget[of_kind] = budget; }
+        inline std::uint32_t Evictions() const { return _evictions; }
+        inline std::uint32_t Failures() const { return _failures; }
+        // IDs in use by textdraws of each kind and priority, walks every ID
+        std::array<std::array<std::uint16_t, static_cast<std::size_t>(textdraw_priority::max_priorities)>, max_kinds> Usage() const;
     };
 
     class TextDrawList
@@ -71,12 +149,23 @@ namespace server
 
         std::vector<std::unique_ptr<TextDraw>> _textdraws;
         std::array<std::vector<std::unique_ptr<PlayerTextDraw>>, MAX_PLAYERS> _player_textdraws;
+        std::vector<stTextDrawData> _td_data; // Layout of the global textdraws, ordered
         std::vector<stTextDrawData> _ptd_data; // Ordered
+        std::vector<layout::group> _groups;
+        textdraw_priority _priority;
+        // Players the whole list was shown to with Show(player), a reload shows them whatever it adds.
+        // Ranges and groups don't count, the layout can't tell whether the new textdraws belong to them.
+        std::bitset<MAX_PLAYERS> _shown_for;
 
         void CreateForPlayer(CPlayer* player);
         void DestroyForPlayer(std::uint16_t playerid);
     public:
-        TextDrawList(const std::string_view file);
+        explicit TextDrawList(layout::document&& layout, textdraw_priority priority = textdraw_priority::hud);
+
+        // Moves the existing textdraws to a new version of the layout. Only what changed in the layout is applied,
+        // so players keep their IDs and whatever the gamemode changed at runtime, click callbacks included. New
+        // textdraws are shown to the players that had the whole list shown
+        void Apply(layout::document&& layout);
 
         void Show(CPlayer* player);
         void Show(CPlayer* player, unsigned short first, unsigned short last);
@@ -84,6 +173,15 @@ namespace server
         void Hide(CPlayer* player);
         void Hide(CPlayer* player, unsigned short first, unsigned short last);
 
+        // Shows or hides a group from the layout file, in the order it lists its elements
+        bool Show(CPlayer* player, std::string_view group);
+        bool Hide(CPlayer* player, std::string_view group);
+        const layout::group* Group(std::string_view name) const;
+
+        // Also applied to the textdraws that already exist
+        void SetPriority(textdraw_priority priority);
+        inline textdraw_priority GetPriority() const { return _priority; }
+
         inline std::vector<stTextDrawData>& PlayerTextData() { return _ptd_data; }
         inline std::vector<std::unique_ptr<TextDraw>>& GetGlobalTextDraws() { return _textdraws; }
         std::vector<std::unique_ptr<PlayerTextDraw>>& GetPlayerTextDraws(CPlayer* player);
@@ -98,15 +196,35 @@ namespace server
         {
             std::unique_ptr<TextDrawList> list;
             Botan::secure_vector<uint8_t> file_csum;
+            std::string file;
+            textdraw_priority priority{ textdraw_priority::hud };
         };
 
+        static constexpr unsigned RELOAD_DELAY = 250; // Editors usually save in several writes
+
         std::unordered_map<std::string, file_list> _td_lists;
 
+        std::filesystem::path _directory;
+        uv_fs_event_t* _watcher{ nullptr };
+        std::unordered_set<std::string> _changed_files;
+        bool _reload_scheduled{ false };
+
+        static void OnDirectoryChanged(uv_fs_event_t* handle, const char* filename, int events, int status);
+        void ReloadChanged();
+
     public:
         TextDrawManager() = default;
         ~TextDrawManager() = default;
 
-        TextDrawList* LoadFile(const std::string_view file, const std::string& id);
+        TextDrawList* LoadFile(const std::string_view file, const std::string& id, textdraw_priority priority = textdraw_priority::hud);
+        // Loads every layout listed in the manifest, files that didn't change since the last call are skipped
+        std::size_t LoadManifest(const std::filesystem::path& path);
+        TextDrawList* Reload(const std::string& id);
+
+        // Reloads layouts automatically when their file is saved
+        bool Watch(const std::filesystem::path& directory);
+        void StopWatching();
+        inline bool Watching() const { return _watcher != nullptr; }
         TextDrawList* operator[](const std::string& name)
         {
             return _td_lists.contains(name) ? _td_lists[name].list.get() : nullptr;
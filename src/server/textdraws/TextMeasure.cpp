@@ -0,0 +1,200 @@
+#include "../../main.hpp"
+
+server::textdraw::CMeasureCache server::textdraw::measure_cache{};
+
+server::textdraw::text_metrics server::textdraw::Measure(std::string_view text, std::uint8_t font, bool proportional)
+{
+	static constexpr std::array<std::uint8_t, 256> no_widths{};
+	const auto& widths = (font < 4 ? TDCharacterWidthLUT[font * 2 + proportional] : no_widths);
+
+	text_metrics metrics;
+	metrics.prefix.resize(text.size() + 1);
+
+	std::uint32_t width = 0u, line_start = 0u;
+	for (std::size_t i = 0, length = text.size(); i < length;)
+	{
+		metrics.prefix[i] = width;
+		const auto character = static_cast<unsigned char>(text[i]);
+
+		if (character == '~')
+		{
+			const auto close = text.find('~', i + 1);
+			if (close == std::string_view::npos)
+			{
+				metrics.valid = false;
+				return metrics;
+			}
+
+			if (close == i + 2 && text[i + 1] == 'n')
+			{
+				metrics.max_line_width = std::max(metrics.max_line_width, width - line_start);
+				line_start = width;
+				++metrics.lines;
+			}
+
+			std::fill(metrics.prefix.begin() + i + 1, metrics.prefix.begin() + close + 1, width);
+			i = close + 1;
+			continue;
+		}
+
+		// Font 3 draws control characters as inline sprites, except at the end of a line
+		if (font == 3 && character > 0 && character < 32 && i != length - 1 && text.substr(i + 1, 3) != "~n~")
+			width += TDFont3CharacterInlineWidth[character];
+		else
+			width += widths[character];
+
+		++i;
+	}
+
+	metrics.prefix.back() = width;
+	metrics.max_line_width = std::max(metrics.max_line_width, width - line_start);
+	return metrics;
+}
+
+int server::textdraw::StringWidth(std::string_view text, std::uint8_t font, std::uint8_t outline, bool proportional)
+{
+	auto metrics = Measure(text, font, proportional);
+	if (!metrics.valid)
+		metrics = Measure("Error: unmatched tilde", font, proportional);
+
+	return static_cast<int>(metrics.max_line_width) + outline * 2;
+}
+
+std::string server::textdraw::WrapText(std::string_view text, float max_width, float letter_size, std::uint8_t font, std::uint8_t outline, bool proportional)
+{
+	const auto metrics = Measure(text, font, proportional);
+	if (!metrics.valid)
+		return std::string{ text };
+
+	std::string result;
+	result.reserve(text.size() + text.size() / 8);
+
+	std::size_t line_start = 0u, copied = 0u;
+	for (std::size_t i = 0, length = text.size(); i < length; ++i)
+	{
+		if (text[i] == '~' && text.substr(i, 3) == "~n~")
+		{
+			line_start = i + 3;
+			i += 2;
+			continue;
+		}
+
+		if (text[i] != ' ' || letter_size * static_cast<float>(metrics.prefix[i] - metrics.prefix[line_start] + outline * 2) <= max_width)
+			continue;
+
+		result.append(text.substr(copied, i - copied));
+		result.append("~n~");
+		copied = line_start = i + 1;
+	}
+
+	result.append(text.substr(copied));
+	return result;
+}
+
+static std::string MeasureKey(std::string_view text, std::initializer_list<float> params)
+{
+	std::string key{ text };
+	key.push_back('\0');
+	key.append(reinterpret_cast<const char*>(params.begin()), params.size() * sizeof(float));
+	return key;
+}
+
+const std::string& server::textdraw::CMeasureCache::Wrap(std::string_view text, float max_width, float letter_size, std::uint8_t font, std::uint8_t outline, bool proportional)
+{
+	auto key = MeasureKey(text, { max_width, letter_size, static_cast<float>(font), static_cast<float>(outline), static_cast<float>(proportional) });
+	if (auto it = _wrapped.find(key); it != _wrapped.end())
+		return it->second;
+
+	if (_wrapped.size() >= MAX_ENTRIES)
+		_wrapped.clear();
+
+	return _wrapped.emplace(std::move(key), WrapText(text, max_width, letter_size, font, outline, proportional)).first->second;
+}
+
+int server::textdraw::CMeasureCache::Width(std::string_view text, std::uint8_t font, std::uint8_t outline, bool proportional)
+{
+	auto key = MeasureKey(text, { static_cast<float>(font), static_cast<float>(outline), static_cast<float>(proportional) });
+	if (auto it = _widths.find(key); it != _widths.end())
+		return it->second;
+
+	if (_widths.size() >= MAX_ENTRIES)
+		_widths.clear();
+
+	return _widths.emplace(std::move(key), StringWidth(text, font, outline, proportional)).first->second;
+}
+
+static command tdmeasure_cmd("tdmeasure", command::make_flag<player::rank::admin>, [](CPlayer* player, cmd::argument_store args) {
+	int iterations{ 1000 };
+
+	try
+	{
+		if (!args.empty())
+			args >> iterations;
+	}
+	catch (const std::exception& e)
+	{
+		player->Chat()->Send(0xDADADAFF, "USO: {ED2B2B}/tdmeasure{DADADA} [iteraciones]");
+		return;
+	}
+
+	iterations = std::clamp(iterations, 1, 100000);
+
+	// Notifications are the hot caller, these are the same kind of messages at growing lengths
+	const std::string_view samples[] = {
+		"Has comprado una botella de agua.",
+		"No tienes suficiente dinero para comprar este producto, te faltan $150.",
+		"Tu vehculo se ha quedado sin gasolina. Ve a una gasolinera o llama a un mecnico para que te ayude a repostar.",
+		"Has sido enviado a la crcel por un administrador. Tiempo restante: 30 minutos. Motivo: conducir de forma temeraria por la ciudad y no respetar las normas de trfico establecidas en el servidor."
+	};
+
+	auto letter_size = [](std::string_view message) {
+		float size = 0.208333f;
+		for (std::size_t i = 0, j = message.length(); i < j; i += 45)
+			size -= 0.015f;
+		return size;
+	};
+
+	auto time = [iterations](const std::function<void()>& fun) {
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; ++i)
+			fun();
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	};
+
+	const auto legacy = time([&] {
+		for (auto&& sample : samples)
+		{
+			std::string split{ sample };
+			server::textdraw::SplitTextDrawString(split, 122.5f, letter_size(sample), 1, 1, true);
+			server::textdraw::GetTextDrawStringWidth(split, 1, 1, true);
+		}
+	});
+
+	const auto engine = time([&] {
+		for (auto&& sample : samples)
+		{
+			auto split = server::textdraw::WrapText(sample, 122.5f, letter_size(sample), 1, 1, true);
+			server::textdraw::StringWidth(split, 1, 1, true);
+		}
+	});
+
+	server::textdraw::measure_cache.Clear();
+	const auto cached = time([&] {
+		for (auto&& sample : samples)
+		{
+			const auto& split = server::textdraw::measure_cache.Wrap(sample, 122.5f, letter_size(sample), 1, 1, true);
+			server::textdraw::measure_cache.Width(split, 1, 1, true);
+		}
+	});
+
+	std::size_t matches = 0u;
+	for (auto&& sample : samples)
+	{
+		std::string split{ sample };
+		server::textdraw::SplitTextDrawString(split, 122.5f, letter_size(sample), 1, 1, true);
+		if (split == server::textdraw::WrapText(sample, 122.5f, letter_size(sample), 1, 1, true))
+			++matches;
+	}
+
+	player->Chat()->Send(0xDADADAFF, "Medir y partir {{ED2B2B}}{}{{DADADA}} textos x {}: anterior {} us, nuevo {} us, con cach {} us ({} iguales).", std::size(samples), iterations, legacy, engine, cached, matches);
+});
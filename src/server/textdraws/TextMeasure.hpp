@@ -0,0 +1,52 @@
+#pragma once
+
+namespace server::textdraw
+{
+	// Width of every character for each font, twice: fixed width first and proportional second
+	constexpr auto TDCharacterWidthLUT = [] {
+		std::array<std::array<std::uint8_t, 256>, 8> lut{};
+		for (std::size_t font = 0; font < TDCharacterWidth.size(); ++font)
+		{
+			for (std::size_t character = 0; character < TDCharacterWidth[font].size(); ++character)
+			{
+				lut[font * 2][character] = TDCharacterDefaultWidth[font];
+				lut[font * 2 + 1][character] = TDCharacterWidth[font][character];
+			}
+		}
+		return lut;
+	}();
+
+	struct text_metrics
+	{
+		// prefix[i] is the width of text[0, i), tokens (`~n~`, colours, keys) don't add anything
+		std::vector<std::uint32_t> prefix;
+		std::uint32_t max_line_width{ 0u };
+		std::uint16_t lines{ 1u };
+		bool valid{ true }; // False on an unmatched tilde, the client draws an error message instead
+	};
+
+	// Single pass over the string, the width of any range is then a subtraction
+	text_metrics Measure(std::string_view text, std::uint8_t font, bool proportional = true);
+
+	int StringWidth(std::string_view text, std::uint8_t font, std::uint8_t outline = 0, bool proportional = true);
+
+	// Same breaking rule as SplitTextDrawString, in linear time: a space becomes `~n~` once the line up to it is wider than `max_width`
+	std::string WrapText(std::string_view text, float max_width, float letter_size, std::uint8_t font, std::uint8_t outline = 0, bool proportional = true);
+
+	class CMeasureCache
+	{
+		static constexpr std::size_t MAX_ENTRIES = 512;
+
+		robin_hood::unordered_map<std::string, std::string> _wrapped;
+		robin_hood::unordered_map<std::string, int> _widths;
+
+	public:
+		const std::string& Wrap(std::string_view text, float max_width, float letter_size, std::uint8_t font, std::uint8_t outline = 0, bool proportional = true);
+		int Width(std::string_view text, std::uint8_t font, std::uint8_t outline = 0, bool proportional = true);
+
+		inline void Clear() { _wrapped.clear(); _widths.clear(); }
+		inline std::size_t Size() const { return _wrapped.size() + _widths.size(); }
+	};
+
+	extern CMeasureCache measure_cache;
+}
@@ -25,6 +25,7 @@ CVehicle::~CVehicle()
 
 	if (_vehicleid != INVALID_VEHICLE_ID)
 	{
+		vehicles::occupancy.Clear(_vehicleid);
 		DestroyVehicle(_vehicleid);
 		vehicles::vehicle_pool[_vehicleid] = nullptr;
 	}
@@ -115,15 +116,11 @@ void CVehicle::ToggleEngineByPlayer(CPlayer* player)
 
 CPlayer* CVehicle::GetDriver()
 {
-	for (auto&& [id, player] : server::player_pool)
-	{
-		if (GetPlayerVehicleID(id) == _vehicleid && GetPlayerState(id) == PLAYER_STATE_DRIVER)
-		{
-			return player.get();
-		}
-	}
+	auto playerid = vehicles::occupancy.Driver(_vehicleid);
+	if (playerid == INVALID_PLAYER_ID)
+		return nullptr;
 
-	return nullptr;
+	return server::player_pool.Get(playerid);
 }
 
 void CVehicle::Update(timers::CTimer* timer)
@@ -328,7 +325,7 @@ static public_hook _v_opsc("OnPlayerStateChange", [](std::uint16_t playerid, int
 
 	if (newstate == PLAYER_STATE_DRIVER)
 	{
-		auto& vehicle = vehicles::vehicle_pool[GetPlayerVehicleID(playerid)];
+		auto& vehicle = vehicles::vehicle_pool[vehicles::occupancy.VehicleOf(playerid)];
 
 		player->Needs()->HideBars();
 		player->Vehicles()->Speedometer()->Show(vehicle.get());
@@ -348,9 +345,9 @@ static public_hook _v_opsc("OnPlayerStateChange", [](std::uint16_t playerid, int
 });
 
 static public_hook _v_opksc("OnPlayerKeyStateChange", [](std::uint16_t playerid, int newkeys, int oldkeys) {
-	if (GetPlayerState(playerid) == PLAYER_STATE_DRIVER)
+	if (vehicles::occupancy.SeatOf(playerid) == 0)
 	{
-		auto& vehicle = vehicles::vehicle_pool[GetPlayerVehicleID(playerid)];
+		auto& vehicle = vehicles::vehicle_pool[vehicles::occupancy.VehicleOf(playerid)];
 		if ((newkeys & KEY_NO) != 0)
 		{
 			vehicle->ToggleEngineByPlayer(server::player_pool[playerid]);
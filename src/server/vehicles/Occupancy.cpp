@@ -0,0 +1,76 @@
+#include "../../main.hpp"
+
+vehicles::COccupancyTable vehicles::occupancy{};
+
+vehicles::COccupancyTable::COccupancyTable()
+{
+	for (auto&& seats : _seats)
+		seats.fill(INVALID_PLAYER_ID);
+}
+
+void vehicles::COccupancyTable::Enter(std::uint16_t playerid, std::uint16_t vehicleid, std::uint8_t seat)
+{
+	if (playerid >= MAX_PLAYERS || vehicleid == 0 || vehicleid >= MAX_VEHICLES || seat >= MAX_SEATS)
+		return;
+
+	auto& current = _players[playerid];
+	if (current.vehicleid == vehicleid && current.seat == seat)
+		return;
+
+	Leave(playerid);
+
+	// Whoever the table had on that seat is stale, the server only lets one player sit there
+	if (auto previous = _seats[vehicleid][seat]; previous != INVALID_PLAYER_ID)
+		_players[previous] = {};
+
+	_seats[vehicleid][seat] = playerid;
+	current = { vehicleid, seat };
+}
+
+void vehicles::COccupancyTable::Leave(std::uint16_t playerid)
+{
+	if (playerid >= MAX_PLAYERS)
+		return;
+
+	auto& current = _players[playerid];
+	if (current.vehicleid != INVALID_VEHICLE_ID && _seats[current.vehicleid][current.seat] == playerid)
+		_seats[current.vehicleid][current.seat] = INVALID_PLAYER_ID;
+
+	current = {};
+}
+
+void vehicles::COccupancyTable::Clear(std::uint16_t vehicleid)
+{
+	if (vehicleid >= MAX_VEHICLES)
+		return;
+
+	for (auto& playerid : _seats[vehicleid])
+	{
+		if (playerid != INVALID_PLAYER_ID)
+			_players[playerid] = {};
+
+		playerid = INVALID_PLAYER_ID;
+	}
+}
+
+std::uint16_t vehicles::COccupancyTable::Occupant(std::uint16_t vehicleid, std::uint8_t seat) const
+{
+	if (vehicleid >= MAX_VEHICLES || seat >= MAX_SEATS)
+		return INVALID_PLAYER_ID;
+
+	return _seats[vehicleid][seat];
+}
+
+// Runs before the other hooks so they already see the new seat
+static public_prehook _vo_opsc("OnPlayerStateChange", +[](std::uint16_t playerid, int newstate, int oldstate) -> cell {
+	if (newstate == PLAYER_STATE_DRIVER || newstate == PLAYER_STATE_PASSENGER)
+	{
+		vehicles::occupancy.Enter(playerid, GetPlayerVehicleID(playerid), (newstate == PLAYER_STATE_DRIVER ? 0 : GetPlayerVehicleSeat(playerid)));
+	}
+	else if (oldstate == PLAYER_STATE_DRIVER || oldstate == PLAYER_STATE_PASSENGER)
+	{
+		vehicles::occupancy.Leave(playerid);
+	}
+
+	return 1;
+});
@@ -0,0 +1,40 @@
+#pragma once
+
+namespace vehicles
+{
+	// Coaches and buses have the most seats, the driver and eight passengers
+	constexpr std::uint8_t MAX_SEATS = 10;
+	constexpr std::uint8_t INVALID_SEAT = 0xFF;
+
+	// Who sits where, kept up to date from state changes and PutInVehicle so the driver of a vehicle or the
+	// vehicle of a player are known without calling natives. Sync packets are never trusted for it, a client
+	// could claim any vehicle and seat and take the driver's place.
+	class COccupancyTable
+	{
+		struct player_seat
+		{
+			std::uint16_t vehicleid{ INVALID_VEHICLE_ID };
+			std::uint8_t seat{ INVALID_SEAT };
+		};
+
+		std::array<std::array<std::uint16_t, MAX_SEATS>, MAX_VEHICLES> _seats;
+		std::array<player_seat, MAX_PLAYERS> _players{};
+
+	public:
+		COccupancyTable();
+		~COccupancyTable() = default;
+
+		void Enter(std::uint16_t playerid, std::uint16_t vehicleid, std::uint8_t seat);
+		void Leave(std::uint16_t playerid);
+		// Forgets everyone sitting in a vehicle that is being destroyed
+		void Clear(std::uint16_t vehicleid);
+
+		std::uint16_t Occupant(std::uint16_t vehicleid, std::uint8_t seat) const;
+		inline std::uint16_t Driver(std::uint16_t vehicleid) const { return Occupant(vehicleid, 0); }
+
+		inline std::uint16_t VehicleOf(std::uint16_t playerid) const { return playerid < MAX_PLAYERS ? _players[playerid].vehicleid : INVALID_VEHICLE_ID; }
+		inline std::uint8_t SeatOf(std::uint16_t playerid) const { return playerid < MAX_PLAYERS ? _players[playerid].seat : INVALID_SEAT; }
+	};
+
+	extern COccupancyTable occupancy;
+}
@@ -0,0 +1,138 @@
+// Offline query tool for the chat and command journal written to scriptfiles/journal.
+// Prints the records of every segment in a directory (or of a single segment) that match the filters,
+// using the segment indexes to skip blocks from other players or outside the time range.
+
+#include "../../src/pch.h"
+#include <fmt/core.h>
+#include <fmt/chrono.h>
+#include <botan/hash.h>
+#include "../../src/server/JournalFormat.hpp"
+
+#include <iomanip>
+#include <sstream>
+
+static std::optional<std::int64_t> ParseTime(const std::string& text)
+{
+	// Local time, the same the segment names use
+	std::tm tm{};
+	std::istringstream stream{ text };
+	stream >> std::get_time(&tm, "%Y-%m-%d %H:%M");
+	if (stream.fail())
+	{
+		stream.clear();
+		stream.str(text);
+		stream >> std::get_time(&tm, "%Y-%m-%d");
+		if (stream.fail())
+			return std::nullopt;
+	}
+
+	tm.tm_isdst = -1;
+	const auto time = std::mktime(&tm);
+	if (time == -1)
+		return std::nullopt;
+
+	return static_cast<std::int64_t>(time) * 1000;
+}
+
+static void PrintUsage(const char* program)
+{
+	fmt::print("usage: {} <journal directory or segment> [--player <name>] [--type chat|command] [--from \"YYYY-MM-DD[ HH:MM]\"] [--to \"YYYY-MM-DD[ HH:MM]\"]\n", program);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	server::journal::query filter;
+	for (int i = 2; i < argc; ++i)
+	{
+		const std::string_view option{ argv[i] };
+		if (i + 1 >= argc)
+		{
+			PrintUsage(argv[0]);
+			return 1;
+		}
+
+		const std::string value{ argv[++i] };
+		if (option == "--player")
+		{
+			filter.name = value;
+		}
+		else if (option == "--type" && (value == "chat" || value == "command"))
+		{
+			filter.type = (value == "chat" ? server::journal::record_type::chat : server::journal::record_type::command);
+		}
+		else if (option == "--from" || option == "--to")
+		{
+			auto time = ParseTime(value);
+			if (!time)
+			{
+				fmt::print("[journal] Invalid date: {}\n", value);
+				return 1;
+			}
+
+			// A bare date in --to includes the whole day
+			if (option == "--from")
+				filter.from = *time;
+			else
+				filter.to = *time + (value.find(':') == std::string::npos ? 24 * 60 * 60 * 1000 : 60 * 1000) - 1;
+		}
+		else
+		{
+			PrintUsage(argv[0]);
+			return 1;
+		}
+	}
+
+	std::vector<std::filesystem::path> segments;
+	const std::filesystem::path path{ argv[1] };
+	std::error_code ec;
+	if (std::filesystem::is_directory(path, ec))
+	{
+		for (auto&& entry : std::filesystem::directory_iterator{ path, ec })
+		{
+			if (entry.is_regular_file() && entry.path().extension() == ".jnl")
+				segments.push_back(entry.path());
+		}
+
+		// Names start with the date, so they sort from oldest to newest
+		std::sort(segments.begin(), segments.end());
+	}
+	else
+	{
+		segments.push_back(path);
+	}
+
+	std::size_t matched = 0u, damaged = 0u;
+	for (auto&& segment : segments)
+	{
+		try
+		{
+			server::journal::CJournalReader reader{ segment };
+			matched += reader.Query(filter, [](const server::journal::record& entry) {
+				const auto time = std::chrono::system_clock::time_point{ std::chrono::milliseconds{ entry.time } };
+				fmt::print("{:%Y-%m-%d %H:%M:%S} {:<8} {} (ID {}, account {}): {}\n",
+					fmt::localtime(std::chrono::system_clock::to_time_t(time)),
+					(entry.type == server::journal::record_type::chat ? "chat" : "command"),
+					entry.name, entry.playerid, entry.account, entry.text);
+			});
+
+			damaged += reader.DamagedBlocks();
+		}
+		catch (const std::exception& e)
+		{
+			fmt::print("[journal] {}: {}\n", segment.string(), e.what());
+		}
+	}
+
+	fmt::print("[journal] {} records matched in {} segments", matched, segments.size());
+	if (damaged)
+		fmt::print(", {} damaged blocks skipped", damaged);
+	fmt::print(".\n");
+
+	return 0;
+}